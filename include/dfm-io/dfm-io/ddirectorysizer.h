@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDIRECTORYSIZER_H
+#define DDIRECTORYSIZER_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/error/error.h>
+
+#include <QObject>
+#include <QUrl>
+#include <QScopedPointer>
+
+BEGIN_IO_NAMESPACE
+
+class DDirectorySizerPrivate;
+
+/*使用示例
+ * DDirectorySizer *sizer = new DDirectorySizer(QUrl::fromLocalFile("/home/user"));
+ * connect(sizer, &DDirectorySizer::sizeChanged, ...);
+ * connect(sizer, &DDirectorySizer::finished, ...);
+ * sizer->start();
+ * 信号在工作线程中发出，接收者需要使用队列连接（默认的 AutoConnection 即可）
+*/
+// total size of a local directory tree, walked by several threads with openat/statx, no file info is created.
+// symlinks are not followed, files with several hard links are counted once
+class DDirectorySizer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Result
+    {
+        qint64 totalSize { 0 };   // apparent size of everything but directories
+        qint64 allocatedSize { 0 };   // blocks on disk of all entries, directories included
+        qint64 fileCount { 0 };   // every entry that is not a directory
+        qint64 dirCount { 0 };   // without the root
+    };
+
+    explicit DDirectorySizer(const QUrl &url, QObject *parent = nullptr);
+    ~DDirectorySizer() override;
+
+    QUrl url() const;
+
+    void setThreadCount(int count);
+    int threadCount() const;
+    // do not descend into directories of other file systems, the mount points themselves are counted
+    void setOneFileSystem(bool oneFileSystem);
+    bool isOneFileSystem() const;
+    // minimum interval of sizeChanged()
+    void setProgressInterval(int msec);
+    int progressInterval() const;
+
+    bool start();
+    // finished() follows once the workers are out, start() may be called again after it.
+    // no effect on a walk that has already counted everything, its result stays complete
+    void cancel();
+    // blocks until the walk is over, returns false if it failed or was canceled
+    bool waitForFinished();
+    bool isRunning() const;
+
+    // the totals counted so far, final after finished()
+    Result result() const;
+    DFMIOError lastError() const;
+
+Q_SIGNALS:
+    void sizeChanged(qint64 totalSize, qint64 allocatedSize, qint64 fileCount);
+    void finished();
+
+private:
+    QScopedPointer<DDirectorySizerPrivate> d;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DDIRECTORYSIZER_H
@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDIRSNAPSHOT_H
+#define DDIRSNAPSHOT_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QSharedDataPointer>
+#include <QStringList>
+#include <QUrl>
+
+BEGIN_IO_NAMESPACE
+
+class DDirSnapshotPrivate;
+
+// (name, inode, mtime, ctime, size) of every entry of a local directory, taken by DEnumerator::snapshot()
+// and brought up to date by DEnumerator::diff()
+class DDirSnapshot
+{
+public:
+    struct Delta
+    {
+        QStringList added;
+        QStringList removed;
+        QStringList modified;   // content or metadata changed, or replaced by another inode
+
+        bool isEmpty() const { return added.isEmpty() && removed.isEmpty() && modified.isEmpty(); }
+    };
+
+    DDirSnapshot();
+    DDirSnapshot(const DDirSnapshot &other);
+    DDirSnapshot &operator=(const DDirSnapshot &other);
+    ~DDirSnapshot();
+
+    bool isValid() const;
+    QUrl dirUrl() const;
+    int count() const;
+    bool contains(const QString &name) const;
+
+private:
+    friend class DEnumerator;
+    QSharedDataPointer<DDirSnapshotPrivate> d;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DDIRSNAPSHOT_H
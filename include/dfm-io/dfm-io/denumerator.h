@@ -7,6 +7,8 @@
 
 #include <dfm-io/dfmio_global.h>
 #include <dfm-io/error/error.h>
+#include <dfm-io/dfileinfo.h>
+#include <dfm-io/ddirsnapshot.h>
 
 #include <QUrl>
 #include <QSharedPointer>
@@ -18,6 +20,7 @@ BEGIN_IO_NAMESPACE
 class DEnumeratorPrivate;
 class DFileInfo;
 class DEnumeratorFuture;
+class DFileTable;
 class DEnumerator : public QEnableSharedFromThis<DEnumerator>
 {
 public:
@@ -83,10 +86,10 @@ public:
         qint64 createNs { 0 };
     };
 
-    enum class EnumeratorType : uint8_t{
-        kEnumeratorGio = 0, // enumerator by gio
-        kEnumeratorFts = 0, // enumerator by fts
-        kEnumeratorSystem = 0, // enumerator by system dirent
+    enum class EnumeratorType : uint8_t {
+        kEnumeratorGio = 0,   // enumerator by gio
+        kEnumeratorFts = 1,   // enumerator by fts
+        kEnumeratorSystem = 2,   // enumerator by system dirent (getdents64 + statx), local file only, others fall back to gio
     };
 
 public:
@@ -95,6 +98,8 @@ public:
     ~DEnumerator();
     QUrl uri() const;
 
+    // wildcard patterns like QDir ("*.jpg", "IMG_??.*", "[a-c]*"), an entry is listed if any pattern matches,
+    // kCaseSensitive is honored, directories are not filtered by name with kAllDirs
     void setNameFilters(const QStringList &filters);
     QStringList nameFilters() const;
 
@@ -116,17 +121,52 @@ public:
     void setSortMixed(bool mix);
     bool isSortMixed() const;
 
+    // attributes are fetched in the listing, the others are loaded by DFileInfo on first access
     void setQueryAttributes(const QString &attributes);
+    // only the attributes the caller reads, plus what the filters need, are fetched
+    void setQueryAttributes(const QList<DFileInfo::AttributeID> &ids);
+    // the attributes as set, the ones the filters need are not included
     QString queryAttributes() const;
 
+    void setEnumeratorType(EnumeratorType type);
+    EnumeratorType enumeratorType() const;
+
+    // walk local subdirectories (kSubdirectories) with several threads when count > 1,
+    // kEnumeratorSystem only, the other types ignore it
+    void setThreadCount(int count);
+    int threadCount() const;
+
+    // multi-threaded walk only: deliver every directory contiguously, parents before children
+    void setOrderedResults(bool ordered);
+    bool isOrderedResults() const;
+
+    // count of files requested by every next_files_async of asyncIterator, the first batch uses it as is,
+    // if adaptive, later batches grow while the backend answers fast and shrink when it becomes slow
+    void setBatchSize(int size);
+    int batchSize() const;
+    void setAdaptiveBatchSize(bool adaptive);
+    bool isAdaptiveBatchSize() const;
+
 public:
     bool cancel();
     bool hasNext() const;
     QUrl next() const;
     QSharedPointer<DFileInfo> fileInfo() const;
+    // local uris are counted from getdents64 without creating file infos, in parallel
+    // when kSubdirectories is set and threadCount() > 1
     quint64 fileCount();
     QList<QSharedPointer<DFileInfo>> fileInfoList();
     QList<QSharedPointer<DEnumerator::SortFileInfo>> sortFileInfoList();
+    // same entries and order as sortFileInfoList(), stored by columns instead of one object per entry
+    DFileTable sortFileTable();
+    // the entries [offset, offset + count) of the order of sortFileTable(), only the requested rows are
+    // selected and sorted, the rest is sorted in the background. the directory is read on the first call,
+    // later calls and changes of the sort settings reuse it
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> sortFileInfoPage(int offset, int count);
+    // local directories only: take the entries of uri(), later diff() returns what changed since and
+    // updates the snapshot, only getdents64 and statx are used, no DFileInfo is created
+    DDirSnapshot snapshot();
+    DDirSnapshot::Delta diff(DDirSnapshot &snapshot);
     DFMIOError lastError() const;
     DEnumeratorFuture *asyncIterator();
     void startAsyncIterator();
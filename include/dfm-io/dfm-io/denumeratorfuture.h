@@ -9,6 +9,8 @@
 #include <dfm-io/denumerator.h>
 
 #include <QObject>
+#include <QList>
+#include <QSharedPointer>
 
 BEGIN_IO_NAMESPACE
 class DEnumerator;
@@ -17,6 +19,7 @@ class DEnumerator;
  * QSharedPointer<DEnumerator> enumerator(new DEnumerator(QUrl()));
  * DEnumeratorFuture *future = enumerator->asyncIterator();
  * 这样才能迭代出来文件。enumerator这里不需要手动析构，future不使用了手动析构
+ * 连接 batchReady 可以在每批文件到达时立即拿到结果，不必等待 asyncIteratorOver
 */
 class DEnumeratorFuture : public QObject
 {
@@ -30,6 +33,7 @@ public:
 
 Q_SIGNALS:
     void asyncIteratorOver();
+    void batchReady(const QList<QSharedPointer<DFileInfo>> &infos);
 
 public:
     bool isFinished();
@@ -38,6 +42,7 @@ public:
 
 public Q_SLOTS:
     void onAsyncIteratorOver();
+    void onBatchReady(const QList<QSharedPointer<DFileInfo>> &infos);
 
 private:
     QSharedPointer<DEnumerator> enumerator { nullptr };
@@ -7,6 +7,7 @@
 
 #include <dfm-io/dfmio_global.h>
 #include <dfm-io/error/error.h>
+#include <dfm-io/dfilemapping.h>
 
 #include <QUrl>
 #include <QSharedPointer>
@@ -77,6 +78,20 @@ public:
     };
     Q_DECLARE_FLAGS(Permissions, Permission)
 
+    enum class AccessHint : uint8_t {
+        kNormal,
+        kSequential,   // larger read ahead
+        kRandom,   // no read ahead
+        kNoReuse,   // the data is read once
+        kWillNeed,   // read the range into the page cache now
+        kDontNeed,   // drop the range from the page cache, written back first if the file is open for writing
+    };
+
+    enum class AsyncEngine : uint8_t {
+        kGio,   // GIO runs the blocking calls on its thread pool
+        kIoUring,   // io_uring for local files, GIO where it is not available
+    };
+
     // callback, use function pointer
     using ReadCallbackFunc = void (*)(qint64, void *);
     using ReadQCallbackFunc = void (*)(QByteArray, void *);
@@ -86,6 +101,13 @@ public:
     using WriteAllCallbackFunc = void (*)(qint64, void *);
     using WriteQCallbackFunc = void (*)(qint64, void *);
 
+    // a buffer of readv() and writev()
+    struct Segment
+    {
+        char *data { nullptr };
+        qint64 size { 0 };
+    };
+
 public:
     explicit DFile(const QUrl &uri);
     explicit DFile(const QString &path);
@@ -113,6 +135,27 @@ public:
     qint64 write(const char *data);
     qint64 write(const QByteArray &byteArray);
 
+    // posix_fadvise(2) of local files, other backends ignore hints and return true. length 0 is up to the end.
+    // kSequential, kRandom and kNoReuse concern the open file, kWillNeed and kDontNeed work on a closed one, too
+    bool advise(AccessHint hint, qint64 offset = 0, qint64 length = 0);
+    // readahead(2), blocks until the reads are queued
+    bool readahead(qint64 offset, qint64 length);
+
+    // positional io of local files, the stream position is neither used nor moved, so several threads
+    // may read or write one open DFile at once. short counts as for pread(2) and pwrite(2).
+    // files opened with kAppend fail writeAt() and writev() with DFM_IO_ERROR_INVALID_ARGUMENT
+    qint64 readAt(qint64 offset, char *data, qint64 maxSize) const;
+    qint64 writeAt(qint64 offset, const char *data, qint64 len);
+    qint64 readv(qint64 offset, const Segment *segments, int count) const;
+    qint64 writev(qint64 offset, const Segment *segments, int count);
+
+    // read only, local files only, the file needs not be open. size -1 maps up to the end of the file
+    DFileMapping map(qint64 offset = 0, qint64 size = -1, DFileMapping::Advice advice = DFileMapping::Advice::kNormal);
+
+    // the engine of readAsync(), readQAsync(), writeAsync(), writeQAsync() and the future variants of read and write
+    void setAsyncEngine(AsyncEngine engine);
+    AsyncEngine asyncEngine() const;
+
     // async callback
     void readAsync(char *data, qint64 maxSize, int ioPriority = 0, ReadCallbackFunc func = nullptr, void *userData = nullptr);
     void readQAsync(qint64 maxSize, int ioPriority = 0, ReadQCallbackFunc func = nullptr, void *userData = nullptr);
@@ -237,10 +237,158 @@ public:
     QString dump() const;
     bool queryAttributeFinished() const;
 
+    // typed reads with the values and fallbacks of attribute(), after the first read of an attribute
+    // no QVariant is created. strings share the cached value, no deep copy is made
+    qint64 size() const;
+    quint32 mode() const;
+    quint64 inode() const;
+    QString name() const;
+    QString displayName() const;
+    // the type follows attributeType(id): quint32, qint32, quint64, qint64, bool or QString
+    template<AttributeID id>
+    auto get() const;
+
+    // the value type of an attribute, kTypeInvalid for attributes without a fixed type
+    static constexpr DFileAttributeType attributeType(AttributeID id);
+
 private:
+    quint64 unsignedValue(AttributeID id) const;
+    qint64 signedValue(AttributeID id) const;
+    bool boolValue(AttributeID id) const;
+    QString stringValue(AttributeID id) const;
+
+    friend class DFileInfoBatchPrivate;
     mutable QSharedDataPointer<DFileInfoPrivate> d;
 };
 
+constexpr DFileInfo::DFileAttributeType DFileInfo::attributeType(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardType:
+    case DFileInfo::AttributeID::kMountableUnixDevice:
+    case DFileInfo::AttributeID::kMountableStartStopType:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+    case DFileInfo::AttributeID::kTimeChangedUsec:
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kUnixDevice:
+    case DFileInfo::AttributeID::kUnixMode:
+    case DFileInfo::AttributeID::kUnixNlink:
+    case DFileInfo::AttributeID::kUnixUID:
+    case DFileInfo::AttributeID::kUnixGID:
+    case DFileInfo::AttributeID::kUnixRdev:
+    case DFileInfo::AttributeID::kUnixBlockSize:
+    case DFileInfo::AttributeID::kFileSystemUsePreview:
+    case DFileInfo::AttributeID::kTrashItemCount:
+        return DFileInfo::DFileAttributeType::kTypeUInt32;
+    case DFileInfo::AttributeID::kStandardSortOrder:
+        return DFileInfo::DFileAttributeType::kTypeInt32;
+    case DFileInfo::AttributeID::kStandardSize:
+    case DFileInfo::AttributeID::kStandardAllocatedSize:
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeAccess:
+    case DFileInfo::AttributeID::kTimeChanged:
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kUnixInode:
+    case DFileInfo::AttributeID::kUnixBlocks:
+    case DFileInfo::AttributeID::kFileSystemSize:
+    case DFileInfo::AttributeID::kFileSystemFree:
+    case DFileInfo::AttributeID::kFileSystemUsed:
+        return DFileInfo::DFileAttributeType::kTypeUInt64;
+    case DFileInfo::AttributeID::kRecentModified:
+        return DFileInfo::DFileAttributeType::kTypeInt64;
+    case DFileInfo::AttributeID::kStandardIsHidden:
+    case DFileInfo::AttributeID::kStandardIsBackup:
+    case DFileInfo::AttributeID::kStandardIsSymlink:
+    case DFileInfo::AttributeID::kStandardIsVirtual:
+    case DFileInfo::AttributeID::kStandardIsVolatile:
+    case DFileInfo::AttributeID::kAccessCanRead:
+    case DFileInfo::AttributeID::kAccessCanWrite:
+    case DFileInfo::AttributeID::kAccessCanExecute:
+    case DFileInfo::AttributeID::kAccessCanDelete:
+    case DFileInfo::AttributeID::kAccessCanTrash:
+    case DFileInfo::AttributeID::kAccessCanRename:
+    case DFileInfo::AttributeID::kMountableCanMount:
+    case DFileInfo::AttributeID::kMountableCanUnmount:
+    case DFileInfo::AttributeID::kMountableCanEject:
+    case DFileInfo::AttributeID::kMountableCanPoll:
+    case DFileInfo::AttributeID::kMountableIsMediaCheckAutomatic:
+    case DFileInfo::AttributeID::kMountableCanStart:
+    case DFileInfo::AttributeID::kMountableCanStartDegraded:
+    case DFileInfo::AttributeID::kMountableCanStop:
+    case DFileInfo::AttributeID::kUnixIsMountPoint:
+    case DFileInfo::AttributeID::kDosIsArchive:
+    case DFileInfo::AttributeID::kDosIsSystem:
+    case DFileInfo::AttributeID::kThumbnailFailed:
+    case DFileInfo::AttributeID::kThumbnailIsValid:
+    case DFileInfo::AttributeID::kFileSystemReadOnly:
+    case DFileInfo::AttributeID::kFileSystemRemote:
+    case DFileInfo::AttributeID::kStandardIsFile:
+    case DFileInfo::AttributeID::kStandardIsDir:
+    case DFileInfo::AttributeID::kStandardIsRoot:
+        return DFileInfo::DFileAttributeType::kTypeBool;
+    case DFileInfo::AttributeID::kStandardName:
+    case DFileInfo::AttributeID::kStandardSymlinkTarget:
+    case DFileInfo::AttributeID::kThumbnailPath:
+    case DFileInfo::AttributeID::kTrashOrigPath:
+        return DFileInfo::DFileAttributeType::kTypeByteString;
+    case DFileInfo::AttributeID::kStandardDisplayName:
+    case DFileInfo::AttributeID::kStandardEditName:
+    case DFileInfo::AttributeID::kStandardCopyName:
+    case DFileInfo::AttributeID::kStandardContentType:
+    case DFileInfo::AttributeID::kStandardFastContentType:
+    case DFileInfo::AttributeID::kStandardTargetUri:
+    case DFileInfo::AttributeID::kStandardDescription:
+    case DFileInfo::AttributeID::kEtagValue:
+    case DFileInfo::AttributeID::kIdFile:
+    case DFileInfo::AttributeID::kIdFilesystem:
+    case DFileInfo::AttributeID::kMountableUnixDeviceFile:
+    case DFileInfo::AttributeID::kMountableHalUdi:
+    case DFileInfo::AttributeID::kOwnerUser:
+    case DFileInfo::AttributeID::kOwnerUserReal:
+    case DFileInfo::AttributeID::kOwnerGroup:
+    case DFileInfo::AttributeID::kFileSystemType:
+    case DFileInfo::AttributeID::kGvfsBackend:
+    case DFileInfo::AttributeID::kSelinuxContext:
+    case DFileInfo::AttributeID::kTrashDeletionDate:
+    case DFileInfo::AttributeID::kStandardSuffix:
+    case DFileInfo::AttributeID::kStandardCompleteSuffix:
+    case DFileInfo::AttributeID::kStandardFilePath:
+    case DFileInfo::AttributeID::kStandardParentPath:
+    case DFileInfo::AttributeID::kStandardBaseName:
+    case DFileInfo::AttributeID::kStandardFileName:
+    case DFileInfo::AttributeID::kStandardCompleteBaseName:
+        return DFileInfo::DFileAttributeType::kTypeString;
+    case DFileInfo::AttributeID::kStandardIcon:
+    case DFileInfo::AttributeID::kStandardSymbolicIcon:
+    case DFileInfo::AttributeID::kPreviewIcon:
+        return DFileInfo::DFileAttributeType::kTypeObject;
+    default:
+        return DFileInfo::DFileAttributeType::kTypeInvalid;
+    }
+}
+
+template<DFileInfo::AttributeID id>
+auto DFileInfo::get() const
+{
+    constexpr DFileAttributeType type = attributeType(id);
+    static_assert(type != DFileAttributeType::kTypeInvalid && type != DFileAttributeType::kTypeObject,
+                  "attribute has no typed accessor, use attribute()");
+
+    if constexpr (type == DFileAttributeType::kTypeUInt32)
+        return static_cast<quint32>(unsignedValue(id));
+    else if constexpr (type == DFileAttributeType::kTypeInt32)
+        return static_cast<qint32>(signedValue(id));
+    else if constexpr (type == DFileAttributeType::kTypeUInt64)
+        return unsignedValue(id);
+    else if constexpr (type == DFileAttributeType::kTypeInt64)
+        return signedValue(id);
+    else if constexpr (type == DFileAttributeType::kTypeBool)
+        return boolValue(id);
+    else
+        return stringValue(id);
+}
+
 END_IO_NAMESPACE
 
 #endif   // DFILEINFO_H
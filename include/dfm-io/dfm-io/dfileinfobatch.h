@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEINFOBATCH_H
+#define DFILEINFOBATCH_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+#include <dfm-io/error/error.h>
+
+#include <QObject>
+#include <QUrl>
+#include <QList>
+#include <QSharedPointer>
+#include <QScopedPointer>
+
+BEGIN_IO_NAMESPACE
+
+class DFileInfoBatchPrivate;
+
+/*使用示例
+ * DFileInfoBatch *batch = new DFileInfoBatch(urls);
+ * batch->setQueryAttributes({ DFileInfo::AttributeID::kStandardSize, DFileInfo::AttributeID::kTimeModified });
+ * connect(batch, &DFileInfoBatch::infosReady, ...);
+ * connect(batch, &DFileInfoBatch::finished, ...);
+ * batch->start();
+ * 信号在工作线程中发出，接收者需要使用队列连接（默认的 AutoConnection 即可）
+*/
+// file infos of many unrelated urls. urls are grouped by parent directory and mount, local files are
+// checked with statx relative to one fd of their directory, each mount has its own concurrency limit,
+// so a slow network mount does not hold up the local disks or get flooded itself.
+// results come in completion order, not in the order of the urls
+class DFileInfoBatch : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DFileInfoBatch(const QList<QUrl> &urls, QObject *parent = nullptr);
+    ~DFileInfoBatch() override;
+
+    QList<QUrl> urls() const;
+
+    // empty for all attributes. if every attribute comes from stat, local files are not queried by gio at all
+    void setQueryAttributes(const QList<DFileInfo::AttributeID> &ids);
+    QList<DFileInfo::AttributeID> queryAttributes() const;
+    void setQueryInfoFlag(DFileInfo::FileQueryInfoFlags flag);
+    DFileInfo::FileQueryInfoFlags queryInfoFlag() const;
+
+    void setThreadCount(int count);
+    int threadCount() const;
+    // parallel queries on one mount, remote ones are network mounts and urls that are not local
+    void setMountConcurrency(int count);
+    int mountConcurrency() const;
+    void setRemoteMountConcurrency(int count);
+    int remoteMountConcurrency() const;
+
+    bool start();
+    // finished() follows once the workers are out, start() may be called again after it
+    void cancel();
+    // blocks until every url is done, returns false if canceled
+    bool waitForFinished();
+    bool isRunning() const;
+    int finishedCount() const;
+
+    DFMIOError lastError() const;
+
+Q_SIGNALS:
+    // the infos of one directory, or of a part of it
+    void infosReady(const QList<QSharedPointer<DFMIO::DFileInfo>> &infos);
+    // urls that do not exist or could not be queried
+    void infosFailed(const QList<QUrl> &urls);
+    void finished();
+
+private:
+    QScopedPointer<DFileInfoBatchPrivate> d;
+};
+
+END_IO_NAMESPACE
+
+Q_DECLARE_METATYPE(QList<QSharedPointer<DFMIO::DFileInfo>>)
+
+#endif   // DFILEINFOBATCH_H
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEINFOCACHE_H
+#define DFILEINFOCACHE_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QObject>
+#include <QUrl>
+#include <QSharedPointer>
+#include <QScopedPointer>
+
+BEGIN_IO_NAMESPACE
+
+class DWatcher;
+class DFileInfoCachePrivate;
+
+// queried file infos shared by the whole process, the least recently used ones are dropped when the
+// cache is full. infos are handed out const: nobody may refresh a shared info, changes come in as
+// DWatcher events that drop the stale entries. infos of urls that are not local expire after a time
+// to live, they are often not watched.
+// the infos are not immutable: reading an attribute that was not queried loads its namespace, and
+// values are cached on first read. both are guarded by locks of the info, so the const methods
+// of a shared info may be called from any thread. refresh() and the setters must not be called
+class DFileInfoCache : public QObject
+{
+    Q_OBJECT
+public:
+    static DFileInfoCache *instance();
+
+    // the cached info, or a new one queried synchronously with all attributes. nullptr if the query fails
+    QSharedPointer<const DFileInfo> info(const QUrl &url);
+    // nullptr if url is not cached, never blocks on I/O
+    QSharedPointer<const DFileInfo> cachedInfo(const QUrl &url);
+    // for infos queried elsewhere, e.g. by DFileInfoBatch. infos not queried yet are queried first,
+    // nothing is cached if that fails. info must not be changed any more
+    void insert(const QSharedPointer<DFileInfo> &info);
+    void remove(const QUrl &url);
+    void clear();
+    int count() const;
+
+    void setMaxCount(int count);
+    int maxCount() const;
+    // 0 keeps infos of urls that are not local until they are dropped
+    void setRemoteTimeToLive(int msec);
+    int remoteTimeToLive() const;
+
+    // drop entries on the events of watcher, the watcher stays owned by the caller
+    void attachWatcher(DWatcher *watcher);
+    // watch a directory with a watcher of the cache, e.g. while a view shows it
+    bool watch(const QUrl &dirUrl);
+    void unwatch(const QUrl &dirUrl);
+
+private:
+    explicit DFileInfoCache(QObject *parent = nullptr);
+    ~DFileInfoCache() override;
+
+    QScopedPointer<DFileInfoCachePrivate> d;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILEINFOCACHE_H
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEMAPPING_H
+#define DFILEMAPPING_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QExplicitlySharedDataPointer>
+
+BEGIN_IO_NAMESPACE
+
+class DFileMappingPrivate;
+
+// a read only view of a local file mapped by DFile::map(), the data stays valid while any copy lives.
+// the pages follow the file: if it is truncated meanwhile, touching data() past the new end raises
+// SIGBUS and kills the process. hashers, previewers and others reading files they do not own should
+// use DFile::read() or readAt() instead, or guard the accesses with a SIGBUS handler of their own
+class DFileMapping
+{
+public:
+    enum class Advice : uint8_t {
+        kNormal,
+        kSequential,   // read ahead more, drop pages behind
+        kRandom,   // no read ahead
+        kWillNeed,   // start reading now
+        kDontNeed,   // the pages may be dropped, they are read again when touched
+    };
+
+    DFileMapping();
+    DFileMapping(const DFileMapping &other);
+    DFileMapping &operator=(const DFileMapping &other);
+    ~DFileMapping();
+
+    bool isValid() const;
+    const char *data() const;
+    qint64 size() const;
+    qint64 offset() const;   // in the file
+    // no copy, the array must not outlive the mapping
+    QByteArray toByteArray() const;
+
+    bool advise(Advice advice) const;
+    // offset and length are relative to data()
+    bool advise(Advice advice, qint64 offset, qint64 length) const;
+
+private:
+    friend class DFile;
+    QExplicitlySharedDataPointer<DFileMappingPrivate> d;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILEMAPPING_H
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILETABLE_H
+#define DFILETABLE_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/denumerator.h>
+
+#include <QSharedDataPointer>
+#include <QUrl>
+
+BEGIN_IO_NAMESPACE
+
+class DFileTablePrivate;
+
+// the entries of one directory stored by columns: all names share one buffer, sizes, times, modes
+// and inodes are kept in contiguous arrays. sorting only reorders an index array.
+// rows are views into the table, valid until the table is changed or destroyed
+class DFileTable
+{
+public:
+    class Row
+    {
+    public:
+        const char *name() const;   // utf-8, '\0' terminated
+        int nameLength() const;
+        QString fileName() const;
+        QUrl url() const;
+
+        qint64 size() const;
+        quint32 mode() const;
+        quint64 inode() const;
+        uint uid() const;
+        uint gid() const;
+        qint64 lastRead() const;
+        qint64 lastReadNs() const;
+        qint64 lastModified() const;
+        qint64 lastModifiedNs() const;
+        qint64 created() const;
+        qint64 createdNs() const;
+
+        bool isDir() const;
+        bool isFile() const;
+        bool isSymLink() const;
+        bool isHide() const;
+        bool isReadable() const;
+        bool isWriteable() const;
+        bool isExecutable() const;
+        QUrl symlinkUrl() const;
+
+        QSharedPointer<DEnumerator::SortFileInfo> toSortFileInfo() const;
+
+    private:
+        friend class DFileTable;
+        Row(const DFileTablePrivate *table, int index);
+
+        const DFileTablePrivate *table { nullptr };
+        int index { 0 };   // index in the columns, not the position in the sorted order
+    };
+
+    DFileTable();
+    explicit DFileTable(const QUrl &dirUrl);
+    DFileTable(const DFileTable &other);
+    DFileTable &operator=(const DFileTable &other);
+    ~DFileTable();
+
+    QUrl dirUrl() const;
+    int count() const;
+    bool isEmpty() const;
+    // the row at position pos of the current order
+    Row row(int pos) const;
+    Row operator[](int pos) const { return row(pos); }
+
+    // without mixDirAndFile directories come first, each part in the given order
+    void sort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile);
+    // only the first count rows get their final position, the others follow unsorted
+    void partialSort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile, int count);
+    // extend the sorted rows of the last sort to count
+    void sortMore(int count);
+    int sortedCount() const;
+
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> toSortFileInfoList() const;
+
+private:
+    friend class DEnumerator;
+    friend class DEnumeratorPrivate;
+    QSharedDataPointer<DFileTablePrivate> d;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILETABLE_H
@@ -0,0 +1,334 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/ddirectorysizer_p.h"
+
+#include "utils/dlocaldirreader.h"
+
+#include <QThread>
+
+#include <sys/sysmacros.h>
+
+#include <gio/gio.h>
+
+USING_IO_NAMESPACE
+
+static constexpr unsigned int kSizeStatMask { STATX_TYPE | STATX_SIZE | STATX_BLOCKS | STATX_NLINK | STATX_INO };
+static constexpr qint64 kFlushEntries { 4096 };   // large directories report progress before they are finished
+
+static uint64_t devOf(const struct statx &st)
+{
+    return static_cast<uint64_t>(makedev(st.stx_dev_major, st.stx_dev_minor));
+}
+
+/************************************************
+ * DDirectorySizerPrivate
+ ***********************************************/
+
+DDirectorySizerPrivate::DDirectorySizerPrivate(DDirectorySizer *q)
+    : q(q),
+      threadCount(qBound(1, QThread::idealThreadCount(), 8))
+{
+}
+
+DDirectorySizerPrivate::~DDirectorySizerPrivate()
+{
+    // no signal from the workers of an object being destroyed
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        destroying = true;
+        canceled = true;
+    }
+    stop();
+}
+
+void DDirectorySizerPrivate::workerLoop(int worker)
+{
+    while (!canceled) {
+        std::string path;
+        if (tasks->take(worker, &path)) {
+            processDir(path, worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> locker(lock);
+        workCondition.wait(locker, [this]() {
+            return canceled || tasks->size() > 0 || pendingDirs == 0;
+        });
+        if (pendingDirs == 0)
+            break;
+    }
+
+    // after a cancel pendingDirs never drops to 0, the last worker out ends the run instead of finishDir()
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        if (--liveWorkers == 0 && canceled && running.exchange(false))
+            notify = !destroying;
+    }
+    if (notify)
+        Q_EMIT q->finished();
+}
+
+void DDirectorySizerPrivate::processDir(const std::string &path, int worker)
+{
+    thread_local DLocalDirReader reader;
+
+    // unreadable subdirectories are skipped like du does, only the root fails the walk
+    if (!reader.open(path.c_str())) {
+        finishDir();
+        return;
+    }
+
+    const std::string prefix = path == "/" ? path : path + "/";
+    Counter counter;
+    qint64 entries = 0;
+
+    DLocalDirReader::Entry entry;
+    while (!canceled && reader.next(&entry)) {
+        struct statx st;
+        if (!reader.stat(entry, kSizeStatMask, false, &st))
+            continue;
+
+        const qint64 blocks = static_cast<qint64>(st.stx_blocks) * 512;
+        if (S_ISDIR(st.stx_mode)) {
+            ++counter.dirCount;
+            counter.allocatedSize += blocks;
+            if (oneFileSystem && devOf(st) != rootDev)
+                continue;
+
+            // pushed under the lock, a worker checking tasks->size() before it waits can not miss it
+            std::lock_guard<std::mutex> locker(lock);
+            ++pendingDirs;
+            tasks->push(worker, prefix + entry.name);
+            workCondition.notify_one();
+        } else {
+            if (st.stx_nlink > 1 && !markLinked(devOf(st), st.stx_ino))
+                continue;
+            ++counter.fileCount;
+            counter.totalSize += static_cast<qint64>(st.stx_size);
+            counter.allocatedSize += blocks;
+        }
+
+        if (++entries % kFlushEntries == 0)
+            flush(&counter);
+    }
+
+    reader.close();
+    flush(&counter);
+    finishDir();
+}
+
+bool DDirectorySizerPrivate::markLinked(uint64_t dev, uint64_t inode)
+{
+    LinkShard &shard = linked[inode % linked.size()];
+    std::lock_guard<std::mutex> locker(shard.lock);
+    return shard.inodes.insert({ dev, inode }).second;
+}
+
+void DDirectorySizerPrivate::flush(Counter *counter)
+{
+    totalSize += counter->totalSize;
+    allocatedSize += counter->allocatedSize;
+    fileCount += counter->fileCount;
+    dirCount += counter->dirCount;
+    *counter = Counter();
+
+    const qint64 now = timer.elapsed();
+    qint64 last = lastProgress;
+    if (!destroying && now - last >= progressInterval && lastProgress.compare_exchange_strong(last, now))
+        Q_EMIT q->sizeChanged(totalSize, allocatedSize, fileCount);
+}
+
+void DDirectorySizerPrivate::finishDir()
+{
+    bool allDone = false;
+    bool notify = false;
+    {
+        // decided together with cancel(), a run is either complete or canceled, never both
+        std::lock_guard<std::mutex> locker(lock);
+        allDone = --pendingDirs == 0;
+        if (allDone && !canceled) {
+            running = false;
+            notify = !destroying;
+        }
+    }
+    if (!allDone)
+        return;
+
+    workCondition.notify_all();
+    if (notify) {
+        Q_EMIT q->sizeChanged(totalSize, allocatedSize, fileCount);
+        Q_EMIT q->finished();
+    }
+    doneCondition.notify_all();
+}
+
+void DDirectorySizerPrivate::stop()
+{
+    workCondition.notify_all();
+    for (auto &worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+    running = false;
+}
+
+/************************************************
+ * DDirectorySizer
+ ***********************************************/
+
+DDirectorySizer::DDirectorySizer(const QUrl &url, QObject *parent)
+    : QObject(parent), d(new DDirectorySizerPrivate(this))
+{
+    d->url = url;
+}
+
+DDirectorySizer::~DDirectorySizer()
+{
+}
+
+QUrl DDirectorySizer::url() const
+{
+    return d->url;
+}
+
+void DDirectorySizer::setThreadCount(int count)
+{
+    d->threadCount = qMax(1, count);
+}
+
+int DDirectorySizer::threadCount() const
+{
+    return d->threadCount;
+}
+
+void DDirectorySizer::setOneFileSystem(bool oneFileSystem)
+{
+    d->oneFileSystem = oneFileSystem;
+}
+
+bool DDirectorySizer::isOneFileSystem() const
+{
+    return d->oneFileSystem;
+}
+
+void DDirectorySizer::setProgressInterval(int msec)
+{
+    d->progressInterval = qMax(0, msec);
+}
+
+int DDirectorySizer::progressInterval() const
+{
+    return d->progressInterval;
+}
+
+bool DDirectorySizer::start()
+{
+    if (d->running)
+        return true;
+
+    if (!d->url.isLocalFile()) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+        return false;
+    }
+
+    d->stop();
+    d->canceled = false;
+    d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_NONE);
+    d->totalSize = 0;
+    d->allocatedSize = 0;
+    d->fileCount = 0;
+    d->dirCount = 0;
+    for (auto &shard : d->linked)
+        shard.inodes.clear();
+
+    std::string root = d->url.toLocalFile().toLocal8Bit().toStdString();
+    while (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+
+    struct statx st;
+    if (!DLocalDirReader::statAt(AT_FDCWD, root.c_str(), kSizeStatMask, true, &st)) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(errno)));
+        return false;
+    }
+
+    d->timer.start();
+    d->lastProgress = 0;
+    d->allocatedSize = static_cast<qint64>(st.stx_blocks) * 512;
+    if (!S_ISDIR(st.stx_mode)) {
+        d->totalSize = static_cast<qint64>(st.stx_size);
+        d->fileCount = 1;
+        Q_EMIT sizeChanged(d->totalSize, d->allocatedSize, d->fileCount);
+        Q_EMIT finished();
+        return true;
+    }
+
+    DLocalDirReader probe;
+    if (!probe.open(root.c_str())) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(probe.lastErrno())));
+        return false;
+    }
+    probe.close();
+
+    d->rootDev = devOf(st);
+    d->tasks.reset(new DWorkStealingQueue<std::string>(d->threadCount));
+    d->pendingDirs = 1;
+    d->liveWorkers = static_cast<size_t>(d->threadCount);
+    d->tasks->push(0, std::move(root));
+    d->running = true;
+    for (int i = 0; i < d->threadCount; ++i)
+        d->workers.emplace_back(&DDirectorySizerPrivate::workerLoop, d.data(), i);
+
+    return true;
+}
+
+void DDirectorySizer::cancel()
+{
+    {
+        // a walk that has counted everything is complete, cancel() comes too late for it
+        std::lock_guard<std::mutex> locker(d->lock);
+        if (!d->running || d->canceled || d->pendingDirs == 0)
+            return;
+        d->canceled = true;
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_CANCELLED);
+    }
+    d->workCondition.notify_all();
+    d->doneCondition.notify_all();
+}
+
+bool DDirectorySizer::waitForFinished()
+{
+    {
+        std::unique_lock<std::mutex> locker(d->lock);
+        d->doneCondition.wait(locker, [this]() {
+            return d->canceled || d->pendingDirs == 0;
+        });
+    }
+    d->stop();
+    std::lock_guard<std::mutex> locker(d->lock);
+    return !d->canceled && d->error.code() == DFMIOErrorCode::DFM_IO_ERROR_NONE;
+}
+
+bool DDirectorySizer::isRunning() const
+{
+    return d->running;
+}
+
+DDirectorySizer::Result DDirectorySizer::result() const
+{
+    Result result;
+    result.totalSize = d->totalSize;
+    result.allocatedSize = d->allocatedSize;
+    result.fileCount = d->fileCount;
+    result.dirCount = d->dirCount;
+    return result;
+}
+
+DFMIOError DDirectorySizer::lastError() const
+{
+    std::lock_guard<std::mutex> locker(d->lock);
+    return d->error;
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/ddirsnapshot_p.h"
+
+#include "utils/dlocaldirreader.h"
+
+#include <errno.h>
+
+USING_IO_NAMESPACE
+
+/************************************************
+ * DDirSnapshotPrivate
+ ***********************************************/
+
+int DDirSnapshotPrivate::scan(DDirSnapshot::Delta *delta, const std::atomic_bool &canceled)
+{
+    DLocalDirReader reader;
+    if (!reader.open(dirPath.constData()))
+        return reader.lastErrno();
+
+    QHash<QByteArray, Entry> current;
+    current.reserve(entries.size());
+
+    DLocalDirReader::Entry dirent;
+    while (reader.next(&dirent)) {
+        if (canceled)
+            return ECANCELED;
+
+        // only the attributes of the snapshot, the entry may be gone since getdents
+        struct statx st;
+        if (!reader.stat(dirent, STATX_INO | STATX_SIZE | STATX_MTIME | STATX_CTIME, false, &st))
+            continue;
+
+        Entry entry;
+        entry.inode = st.stx_ino;
+        entry.size = static_cast<qint64>(st.stx_size);
+        entry.mtimeSec = st.stx_mtime.tv_sec;
+        entry.mtimeNsec = st.stx_mtime.tv_nsec;
+        entry.ctimeSec = st.stx_ctime.tv_sec;
+        entry.ctimeNsec = st.stx_ctime.tv_nsec;
+
+        const QByteArray name(dirent.name, static_cast<int>(dirent.nameLength));
+        if (delta) {
+            auto it = entries.constFind(name);
+            if (it == entries.constEnd()) {
+                delta->added.append(QString::fromLocal8Bit(name));
+            } else if (it->inode != entry.inode || it->ctimeSec != entry.ctimeSec || it->ctimeNsec != entry.ctimeNsec) {
+                // every write and every metadata change updates ctime, same inode and ctime means unchanged
+                delta->modified.append(QString::fromLocal8Bit(name));
+            }
+        }
+        current.insert(name, entry);
+    }
+
+    if (reader.lastErrno() != 0)
+        return reader.lastErrno();
+
+    if (delta) {
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            if (!current.contains(it.key()))
+                delta->removed.append(QString::fromLocal8Bit(it.key()));
+        }
+    }
+
+    entries.swap(current);
+    valid = true;
+    return 0;
+}
+
+/************************************************
+ * DDirSnapshot
+ ***********************************************/
+
+DDirSnapshot::DDirSnapshot()
+    : d(new DDirSnapshotPrivate)
+{
+}
+
+DDirSnapshot::DDirSnapshot(const DDirSnapshot &other) = default;
+
+DDirSnapshot &DDirSnapshot::operator=(const DDirSnapshot &other) = default;
+
+DDirSnapshot::~DDirSnapshot() = default;
+
+bool DDirSnapshot::isValid() const
+{
+    return d->valid;
+}
+
+QUrl DDirSnapshot::dirUrl() const
+{
+    return d->dirUrl;
+}
+
+int DDirSnapshot::count() const
+{
+    return d->entries.size();
+}
+
+bool DDirSnapshot::contains(const QString &name) const
+{
+    return d->entries.contains(name.toLocal8Bit());
+}
@@ -3,26 +3,43 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "private/denumerator_p.h"
+#include "private/dfiletable_p.h"
+#include "private/ddirsnapshot_p.h"
 
 #include "utils/dlocalhelper.h"
+#include "utils/dattributetable.h"
 
 #include <dfm-io/denumerator.h>
 #include <dfm-io/dfileinfo.h>
 #include <dfm-io/denumeratorfuture.h>
+#include <dfm-io/dfiletable.h>
 
 #include <QVariant>
 #include <QPointer>
+#include <QMetaMethod>
 #include <QtConcurrent>
 #include <QDebug>
 #include <qobjectdefs.h>
 
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <limits>
+
+// thumbnail::*, preview::*, filesystem::* and selinux::* cost extra syscalls (filesystem::* a statfs) per entry,
+// they are not queried by default and DFileInfo loads them on first access
 #define FILE_DEFAULT_ATTRIBUTES "standard::*,etag::*,id::*,access::*,mountable::*,time::*,unix::*,dos::*,\
-owner::*,thumbnail::*,preview::*,filesystem::*,gvfs::*,selinux::*,trash::*,recent::*,metadata::*"
+owner::*,gvfs::*,trash::*,recent::*,metadata::*"
 
 USING_IO_NAMESPACE
 
+static constexpr int kMinBatchSize { 16 };
+static constexpr int kMaxBatchSize { 4096 };
+static constexpr qint64 kBatchTargetLatency { 50 };   // ms
+static constexpr size_t kCountBufferSize { 256 * 1024 };   // getdents64 buffer of the root when only counting
+static constexpr int kMaxHideLists { 256 };   // .hidden files kept for a walk of subdirectories
+
 /************************************************
  * DEnumeratorPrivate
  ***********************************************/
@@ -30,16 +47,21 @@ USING_IO_NAMESPACE
 DEnumeratorPrivate::DEnumeratorPrivate(DEnumerator *q)
     : q(q)
 {
-    queryAttributes = FILE_DEFAULT_ATTRIBUTES;
+    updateProjection();
 }
 
 DEnumeratorPrivate::~DEnumeratorPrivate()
 {
+    stopPageFill();
     clean();
     if (cancellable) {
         g_object_unref(cancellable);
         cancellable = nullptr;
     }
+    if (uriGFile) {
+        g_object_unref(uriGFile);
+        uriGFile = nullptr;
+    }
 }
 
 bool DEnumeratorPrivate::init(const QUrl &url)
@@ -80,17 +102,32 @@ void DEnumeratorPrivate::clean()
                 break;
         }
     }
+    hideListOwner = nullptr;
+
+    while (!stackLocalDir.isEmpty())
+        delete stackLocalDir.pop();
+    visitedDirs.clear();
+
+    walker.reset();
+    walkerBatch.clear();
+    walkerBatchPos = 0;
 }
 
 bool DEnumeratorPrivate::createEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me)
 {
+    if (isParallelEnumerator())
+        return createParallelEnumerator(url, me);
+
+    if (isLocalEnumerator())
+        return createLocalEnumerator(url, me);
+
     const QString &uriPath = url.toString();
     g_autoptr(GFile) gfile = g_file_new_for_uri(uriPath.toLocal8Bit().data());
 
     g_autoptr(GError) gerror = nullptr;
     checkAndResetCancel();
     GFileEnumerator *genumerator = g_file_enumerate_children(gfile,
-                                                             queryAttributes.toStdString().c_str(),
+                                                             projectedAttributes(),
                                                              enumLinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                                                              cancellable,
                                                              &gerror);
@@ -111,181 +148,320 @@ bool DEnumeratorPrivate::createEnumerator(const QUrl &url, QPointer<DEnumeratorP
     return ret;
 }
 
-void DEnumeratorPrivate::checkAndResetCancel()
+bool DEnumeratorPrivate::createLocalEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me)
 {
-    if (cancellable) {
-        g_object_unref(cancellable);
-        cancellable = nullptr;
+    const QByteArray &path = url.toLocalFile().toLocal8Bit();
+    LocalDirNode *node = new LocalDirNode;
+    bool ret = node->reader.open(path.constData());
+    if (!me) {
+        delete node;
+        error.setCode(DFMIOErrorCode(DFM_IO_ERROR_NOT_FOUND));
+        return false;
     }
-    cancellable = g_cancellable_new();
+
+    if (!ret) {
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(node->reader.lastErrno())));
+        qWarning() << "create local enumerator failed, url: " << url << " error: " << error.errorMsg();
+        delete node;
+    } else {
+        node->path = path;
+        stackLocalDir.push(node);
+        visitedDirs.clear();
+        if (enumLinks)
+            markVisited(node->reader.fd(), &visitedDirs);
+    }
+    waitCondition.wakeAll();
+    return ret;
 }
 
-void DEnumeratorPrivate::setErrorFromGError(GError *gerror)
+bool DEnumeratorPrivate::isLocalEnumerator() const
 {
-    if (!gerror)
-        return;
-    error.setCode(DFMIOErrorCode(gerror->code));
-    if (error.code() == DFMIOErrorCode::DFM_IO_ERROR_FAILED)
-        error.setMessage(gerror->message);
+    return enumeratorType == DEnumerator::EnumeratorType::kEnumeratorSystem && uri.isLocalFile();
 }
 
-bool DEnumeratorPrivate::checkFilter()
+bool DEnumeratorPrivate::hasNextLocal()
 {
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter))
-        return true;
+    while (!stackLocalDir.isEmpty()) {
+        if (localCanceled) {
+            error.setCode(DFMIOErrorCode(DFM_IO_ERROR_CANCELLED));
+            return false;
+        }
 
-    if (!dfileInfoNext)
-        return false;
+        LocalDirNode *node = stackLocalDir.top();
+        DLocalDirReader::Entry entry;
+        if (!node->reader.next(&entry)) {
+            if (node->reader.lastErrno() != 0)
+                error.setCode(DFMIOErrorCode(g_io_error_from_errno(node->reader.lastErrno())));
+            delete stackLocalDir.pop();
+            continue;
+        }
 
-    // 1. 首先处理特殊目录 "." 和 ".."
-    const QString &fileName = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardName).toString();
-    if (!shouldShowDotAndDotDot(fileName))
-        return false;
+        nextPath = node->path;
+        if (!nextPath.endsWith('/'))
+            nextPath.append('/');
+        nextPath.append(entry.name, static_cast<int>(entry.nameLength));
+        nextUrl.clear();
+        dfileInfoNext.reset();
+        nextStatMask = 0;
+
+        // 只有 d_type 未知时才需要 statx 取类型
+        unsigned char type = entry.type;
+        if (type == DT_UNKNOWN && node->reader.stat(entry, STATX_TYPE, false, &nextStat)) {
+            nextStatMask = nextStat.stx_mask;
+            type = DLocalDirReader::typeFromMode(nextStat.stx_mode);
+        }
 
-    // 2. 处理目录和文件的过滤
-    if (!checkEntryTypeFilter())
-        return false;
+        if (enumSubDir) {
+            bool isDir = type == DT_DIR;
+            if (type == DT_LNK && enumLinks) {
+                struct statx target;
+                isDir = node->reader.stat(entry, STATX_TYPE, true, &target) && S_ISDIR(target.stx_mode);
+            }
+            if (isDir) {
+                LocalDirNode *child = new LocalDirNode;
+                // a followed link to an ancestor is listed, but not walked again
+                if (child->reader.openAt(node->reader.fd(), entry.name) && (!enumLinks || markVisited(child->reader.fd(), &visitedDirs))) {
+                    child->path = nextPath;
+                    stackLocalDir.push(child);
+                } else {
+                    delete child;
+                }
+            }
+        }
 
-    // 3. 处理权限过滤
-    if (!checkPermissionFilter())
-        return false;
+        if (!checkLocalFilter(node->reader.fd(), entry.name, entry.name, entry.nameLength, type, node->path))
+            continue;
 
-    // 4. 处理符号链接过滤
-    if (!checkSymlinkFilter())
-        return false;
+        return true;
+    }
 
-    // 5. 处理隐藏文件过滤
-    if (!checkHiddenFilter())
-        return false;
+    return false;
+}
+
+bool DEnumeratorPrivate::createParallelEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me)
+{
+    DLocalParallelWalker::Options options;
+    options.threadCount = threadCount;
+    options.followSymlinks = enumLinks;
+    options.ordered = orderedResults;
 
-    // 6. 处理文件名过滤器
-    if (!checkNameFilter(fileName))
+    DLocalParallelWalker *newWalker = new DLocalParallelWalker(url.toLocalFile().toLocal8Bit().toStdString(), options);
+    bool ret = newWalker->start();
+    if (!me) {
+        delete newWalker;
+        error.setCode(DFMIOErrorCode(DFM_IO_ERROR_NOT_FOUND));
         return false;
+    }
 
-    return true;
+    if (!ret) {
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(newWalker->lastErrno())));
+        qWarning() << "create parallel enumerator failed, url: " << url << " error: " << error.errorMsg();
+        delete newWalker;
+    } else {
+        walker.reset(newWalker);
+        walkerBatch.clear();
+        walkerBatchPos = 0;
+    }
+    waitCondition.wakeAll();
+    return ret;
 }
 
-bool DEnumeratorPrivate::shouldShowDotAndDotDot(const QString &fileName)
+bool DEnumeratorPrivate::isParallelEnumerator() const
 {
-    const bool isDot = (fileName == ".");
-    const bool isDotDot = (fileName == "..");
+    // the walker reads by system dirent too, gio and fts stay single threaded as asked
+    return threadCount > 1 && enumSubDir && isLocalEnumerator();
+}
 
-    if (isDot && (dirFilters.testFlag(DEnumerator::DirFilter::kNoDot) || dirFilters.testFlag(DEnumerator::DirFilter::kNoDotAndDotDot)))
+bool DEnumeratorPrivate::hasNextParallel()
+{
+    if (!walker)
         return false;
 
-    if (isDotDot && (dirFilters.testFlag(DEnumerator::DirFilter::kNoDotDot) || dirFilters.testFlag(DEnumerator::DirFilter::kNoDotAndDotDot)))
-        return false;
+    while (true) {
+        if (walkerBatchPos >= walkerBatch.size()) {
+            walkerBatchPos = 0;
+            if (!walker->nextBatch(&walkerBatch)) {
+                walkerBatch.clear();
+                if (localCanceled)
+                    error.setCode(DFMIOErrorCode(DFM_IO_ERROR_CANCELLED));
+                else if (walker->lastErrno() != 0)
+                    error.setCode(DFMIOErrorCode(g_io_error_from_errno(walker->lastErrno())));
+                return false;
+            }
+            continue;
+        }
 
-    return true;
+        const size_t index = walkerBatchPos++;
+        const std::string &dirPath = walkerBatch.dirPath;
+        const char *name = walkerBatch.name(index);
+        nextPath = QByteArray(dirPath.data(), static_cast<int>(dirPath.size()));
+        if (!nextPath.endsWith('/'))
+            nextPath.append('/');
+        const int dirLength = nextPath.size();
+        nextPath.append(name);
+        nextUrl.clear();
+        dfileInfoNext.reset();
+        nextStatMask = 0;
+
+        if (checkLocalFilter(AT_FDCWD, nextPath.constData(), nextPath.constData() + dirLength, static_cast<size_t>(nextPath.size() - dirLength),
+                             walkerBatch.types[index], QByteArray::fromRawData(dirPath.data(), static_cast<int>(dirPath.size()))))
+            return true;
+    }
 }
 
-bool DEnumeratorPrivate::checkEntryTypeFilter()
+bool DEnumeratorPrivate::checkLocalFilter(int dirFd, const char *path, const char *name, size_t nameLength, unsigned char type, const QByteArray &dirPath)
 {
-    const bool isDir = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool();
-    const bool isSymlink = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool();
-    
-    // kAllDirs: 显示所有目录，包括符号链接指向的目录
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kAllDirs)) {
-        if (isDir)
+    DEntryFilter &filter = compiledFilter();
+    if (!filter.isEnabled())
+        return true;
+
+    if (filter.needsHideList())
+        useHideListOf(dirPath);
+
+    DEntryFilter::Entry entry;
+    entry.name = name;
+    entry.nameLength = nameLength;
+    entry.type = type;
+    entry.isSymlink = type == DT_LNK;
+
+    return filter.accept(entry, [&](DEntryFilter::Entry &e, DEntryFilter::Need need) {
+        if (need == DEntryFilter::Need::kAccess) {
+            e.accessible = faccessat(dirFd, path, filter.accessMode(), 0) == 0;
             return true;
-            
-        if (isSymlink) {
-            // 对于符号链接，需要检查其目标
-            const QString targetPath = dfileInfoNext->attribute(
-                DFileInfo::AttributeID::kStandardSymlinkTarget).toString();
-            if (!targetPath.isEmpty()) {
-                // 如果是相对路径，需要转换为绝对路径
-                QString absoluteTargetPath = targetPath;
-                if (QDir::isRelativePath(targetPath)) {
-                    const QString parentPath = dfileInfoNext->attribute(
-                        DFileInfo::AttributeID::kStandardParentPath).toString();
-                    absoluteTargetPath = QDir(parentPath).absoluteFilePath(targetPath);
-                }
-                
-                QUrl targetUrl = QUrl::fromLocalFile(absoluteTargetPath);
-                QSharedPointer<DFileInfo> targetInfo = DLocalHelper::createFileInfoByUri(targetUrl);
-                if (targetInfo) {
-                    return targetInfo->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool();
-                }
-            }
         }
-        return false;
+
+        struct statx st;
+        if (!DLocalDirReader::statAt(dirFd, path, STATX_TYPE, true, &st))
+            return false;
+        e.targetType = DLocalDirReader::typeFromMode(st.stx_mode);
+        return true;
+    });
+}
+
+void DEnumeratorPrivate::checkAndResetCancel()
+{
+    if (cancellable) {
+        g_object_unref(cancellable);
+        cancellable = nullptr;
     }
-    
-    // 如果没有指定 kAllDirs，则根据 kDirs 和 kFiles 过滤
-    const bool wantDirs = dirFilters.testFlag(DEnumerator::DirFilter::kDirs);
-    const bool wantFiles = dirFilters.testFlag(DEnumerator::DirFilter::kFiles);
-    const bool isFile = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsFile).toBool();
-    
-    // 如果既不要目录也不要文件，返回 false
-    if (!wantDirs && !wantFiles)
-        return false;
-        
-    // 如果只要目录
-    if (wantDirs && !wantFiles)
-        return isDir;
-        
-    // 如果只要文件
-    if (!wantDirs && wantFiles)
-        return isFile;
-        
-    // 如果都要
-    return true;
+    cancellable = g_cancellable_new();
+}
+
+void DEnumeratorPrivate::setErrorFromGError(GError *gerror)
+{
+    if (!gerror)
+        return;
+    error.setCode(DFMIOErrorCode(gerror->code));
+    if (error.code() == DFMIOErrorCode::DFM_IO_ERROR_FAILED)
+        error.setMessage(gerror->message);
 }
 
-bool DEnumeratorPrivate::checkPermissionFilter()
+bool DEnumeratorPrivate::checkFilter(GFileInfo *gfileInfo, GFile *dir)
 {
-    if (!dirFilters.testFlag(DEnumerator::DirFilter::kReadable) && !dirFilters.testFlag(DEnumerator::DirFilter::kWritable) && !dirFilters.testFlag(DEnumerator::DirFilter::kExecutable))
+    DEntryFilter &filter = compiledFilter();
+    if (!filter.isEnabled())
         return true;
 
-    const bool readable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanRead).toBool();
-    const bool writable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanWrite).toBool();
-    const bool executable = dfileInfoNext->attribute(DFileInfo::AttributeID::kAccessCanExecute).toBool();
-
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kReadable) && !readable)
-        return false;
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kWritable) && !writable)
+    if (!gfileInfo)
         return false;
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kExecutable) && !executable)
+
+    if (filter.needsHideList())
+        useHideListOf(dir);
+
+    DEntryFilter::Entry entry;
+    entry.name = g_file_info_get_name(gfileInfo);
+    if (!entry.name)
         return false;
+    entry.nameLength = strlen(entry.name);
+    entry.type = DEntryFilter::typeFromGFileType(g_file_info_get_file_type(gfileInfo));
+    entry.isSymlink = g_file_info_get_is_symlink(gfileInfo);
+
+    return filter.accept(entry, [&](DEntryFilter::Entry &e, DEntryFilter::Need need) {
+        if (need == DEntryFilter::Need::kAccess) {
+            const int mode = filter.accessMode();
+            e.accessible = (!(mode & R_OK) || g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_READ))
+                    && (!(mode & W_OK) || g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE))
+                    && (!(mode & X_OK) || g_file_info_get_attribute_boolean(gfileInfo, G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE));
+            return true;
+        }
 
-    return true;
+        // 对于符号链接，需要检查其目标
+        if (!dir || !g_file_info_has_attribute(gfileInfo, G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET))
+            return false;
+        const char *target = g_file_info_get_symlink_target(gfileInfo);
+        if (!target || !*target)
+            return false;
+        g_autoptr(GFile) targetFile = g_file_resolve_relative_path(dir, target);
+        g_autofree gchar *targetPath = g_file_get_path(targetFile);
+        struct statx st;
+        if (!targetPath || !DLocalDirReader::statAt(AT_FDCWD, targetPath, STATX_TYPE, true, &st))
+            return false;
+        e.targetType = DLocalDirReader::typeFromMode(st.stx_mode);
+        return true;
+    });
 }
 
-bool DEnumeratorPrivate::checkSymlinkFilter()
+bool DEnumeratorPrivate::markVisited(int dirFd, QSet<QPair<quint64, quint64>> *visited)
 {
-    if (!dirFilters.testFlag(DEnumerator::DirFilter::kNoSymLinks))
+    struct stat st;
+    if (fstat(dirFd, &st) != 0)
         return true;
 
-    return !dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool();
+    const QPair<quint64, quint64> key(static_cast<quint64>(st.st_dev), static_cast<quint64>(st.st_ino));
+    if (visited->contains(key))
+        return false;
+    visited->insert(key);
+    return true;
 }
 
-bool DEnumeratorPrivate::checkHiddenFilter()
+DEntryFilter &DEnumeratorPrivate::compiledFilter()
 {
-    if (dirFilters.testFlag(DEnumerator::DirFilter::kHidden))
-        return true;
+    if (filterDirty) {
+        entryFilter.compile(dirFilters, nameFilters, enumLinks);
+        filterDirty = false;
+    }
+    return entryFilter;
+}
 
-    const QString &parentPath = dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardParentPath).toString();
-    const QUrl &urlHidden = QUrl::fromLocalFile(parentPath + "/.hidden");
+void DEnumeratorPrivate::useHideListOf(const QByteArray &dirPath)
+{
+    if (hideListDir == dirPath)
+        return;
+    // dirPath may be raw data of a walker batch that is gone after the next batch, what is kept owns its bytes
+    hideListDir = QByteArray(dirPath.constData(), dirPath.size());
 
-    QSet<QString> hideList;
-    if (hideListMap.count(urlHidden) > 0) {
-        hideList = hideListMap.value(urlHidden);
-    } else {
-        hideList = DLocalHelper::hideListFromUrl(urlHidden);
-        hideListMap.insert(urlHidden, hideList);
+    if (dirPath.isEmpty()) {
+        entryFilter.setHideList(nullptr);
+        return;
     }
 
-    return !DLocalHelper::fileIsHidden(dfileInfoNext.data(), hideList, false);
+    auto it = hideListMap.find(dirPath);
+    if (it == hideListMap.end()) {
+        // the filter points into the map, it is pointed at the new list below
+        if (hideListMap.size() >= kMaxHideLists)
+            hideListMap.clear();
+        const QUrl &urlHidden = QUrl::fromLocalFile(QString::fromLocal8Bit(dirPath) + "/.hidden");
+        it = hideListMap.insert(hideListDir, DLocalHelper::hideListFromUrl(urlHidden));
+    }
+    entryFilter.setHideList(&it.value());
 }
 
-bool DEnumeratorPrivate::checkNameFilter(const QString &fileName)
+void DEnumeratorPrivate::useHideListOf(GFile *dir)
 {
-    if (nameFilters.isEmpty())
-        return true;
+    // the path is only built when the directory changes
+    if (dir == hideListOwner)
+        return;
+    hideListOwner = dir;
 
-    const bool caseSensitive = dirFilters.testFlag(DEnumerator::DirFilter::kCaseSensitive);
-    return !nameFilters.contains(fileName, caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    g_autofree gchar *path = dir ? g_file_get_path(dir) : nullptr;
+    useHideListOf(QByteArray(path));
+}
+
+GFile *DEnumeratorPrivate::uriFile()
+{
+    if (!uriGFile)
+        uriGFile = g_file_new_for_uri(uri.toString().toLocal8Bit().data());
+    return uriGFile;
 }
 
 bool DEnumeratorPrivate::openDirByfts()
@@ -295,19 +471,9 @@ bool DEnumeratorPrivate::openDirByfts()
         path = path.left(path.length() - 1);
     char *paths[2] = { nullptr, nullptr };
     paths[0] = strdup(path.toUtf8().toStdString().data());
-    int (*compare)(const FTSENT **, const FTSENT **);
-    compare = nullptr;
-    if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName) {
-        compare = DLocalHelper::compareByName;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize) {
-        compare = DLocalHelper::compareBySize;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastModified) {
-        compare = DLocalHelper::compareByLastModifed;
-    } else if (sortRoleFlag == DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastRead) {
-        compare = DLocalHelper::compareByLastRead;
-    }
 
-    fts = fts_open(paths, FTS_COMFOLLOW, compare);
+    // entries are sorted by DFileTable with precomputed name keys, not by fts
+    fts = fts_open(paths, FTS_COMFOLLOW, nullptr);
 
     if (paths[0])
         free(paths[0]);
@@ -321,26 +487,6 @@ bool DEnumeratorPrivate::openDirByfts()
     return true;
 }
 
-void DEnumeratorPrivate::insertSortFileInfoList(QList<QSharedPointer<DEnumerator::SortFileInfo>> &fileList, QList<QSharedPointer<DEnumerator::SortFileInfo>> &dirList, FTSENT *ent, FTS *fts, const QSet<QString> &hideList)
-{
-    auto sortInfo = DLocalHelper::createSortFileInfo(ent, hideList);
-    if (sortInfo->isDir && !sortInfo->isSymLink)
-        fts_set(fts, ent, FTS_SKIP);
-
-    if (sortInfo->isDir && !isMixDirAndFile) {
-        if (sortOrder == Qt::DescendingOrder)
-            dirList.push_front(sortInfo);
-        else
-            dirList.push_back(sortInfo);
-        return;
-    }
-
-    if (sortOrder == Qt::DescendingOrder)
-        fileList.push_front(sortInfo);
-    else
-        fileList.push_back(sortInfo);
-}
-
 void DEnumeratorPrivate::enumUriAsyncOvered(GList *files)
 {
     asyncOvered = !files;
@@ -348,11 +494,58 @@ void DEnumeratorPrivate::enumUriAsyncOvered(GList *files)
         asyncIteratorOver();
         return;
     }
+
+    const bool needBatch = isSignalConnected(QMetaMethod::fromSignal(&DEnumeratorPrivate::asyncBatchReady));
+    QList<QSharedPointer<DFileInfo>> batch;
     GList *l;
     for (l = files; l != nullptr; l = l->next) {
-        asyncInfos.append(static_cast<GFileInfo *>(l->data));
+        GFileInfo *gfileInfo = static_cast<GFileInfo *>(l->data);
+        asyncInfos.append(gfileInfo);
+        if (!needBatch || !gfileInfo)
+            continue;
+
+        if (!checkFilter(gfileInfo, uriFile()))
+            continue;
+
+        batch.append(DLocalHelper::createFileInfoByUri(asyncChildUrl(gfileInfo), g_file_info_dup(gfileInfo), projectedAttributes(),
+                                                       enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks));
     }
     g_list_free(files);
+
+    if (!batch.isEmpty())
+        Q_EMIT asyncBatchReady(batch);
+}
+
+void DEnumeratorPrivate::nextFilesAsync(EnumUriData *data)
+{
+    checkAndResetCancel();
+    batchTimer.start();
+    g_file_enumerator_next_files_async(data->enumerator,
+                                       requestedBatchSize,
+                                       G_PRIORITY_DEFAULT,
+                                       cancellable,
+                                       moreFilesCallback,
+                                       data);
+}
+
+int DEnumeratorPrivate::adaptBatchSize(int received)
+{
+    if (!adaptiveBatchSize)
+        return batchSize;
+
+    // 后端响应快则加大批次减少回调次数，响应慢则减小批次尽快交付结果
+    const qint64 elapsed = batchTimer.elapsed();
+    if (received >= requestedBatchSize && elapsed < kBatchTargetLatency / 2)
+        return qMin(requestedBatchSize * 2, qMax(kMaxBatchSize, batchSize));
+    if (elapsed > kBatchTargetLatency)
+        return qMax(requestedBatchSize / 2, qMin(kMinBatchSize, batchSize));
+    return requestedBatchSize;
+}
+
+QUrl DEnumeratorPrivate::asyncChildUrl(GFileInfo *gfileInfo) const
+{
+    const QString &name = QString(g_file_info_get_name(gfileInfo));
+    return QUrl::fromLocalFile(uri.path() == "/" ? "/" + name : uri.path() + "/" + name);
 }
 
 void DEnumeratorPrivate::startAsyncIterator()
@@ -362,11 +555,15 @@ void DEnumeratorPrivate::startAsyncIterator()
     const QString &uriPath = uri.toString();
     g_autoptr(GFile) gfile = g_file_new_for_uri(uriPath.toLocal8Bit().data());
 
+    // the callbacks only read the filter and the hide list, both are built here
+    if (compiledFilter().needsHideList())
+        useHideListOf(uriFile());
+
     checkAndResetCancel();
     EnumUriData *userData = new EnumUriData();
     userData->pointer = sharedFromThis();
     g_file_enumerate_children_async(gfile,
-                                    queryAttributes.toStdString().c_str(),
+                                    projectedAttributes(),
                                     G_FILE_QUERY_INFO_NONE,
                                     G_PRIORITY_DEFAULT,
                                     cancellable,
@@ -385,16 +582,18 @@ bool DEnumeratorPrivate::hasNext()
         if (!gfileInfo)
             continue;
 
-        auto path = uri.path() == "/" ? "/" + QString(g_file_info_get_name(gfileInfo)) : uri.path() + "/" + QString(g_file_info_get_name(gfileInfo));
-        nextUrl = QUrl::fromLocalFile(path);
+        if (!checkFilter(gfileInfo, uriFile())) {
+            g_object_unref(gfileInfo);
+            continue;
+        }
 
-        dfileInfoNext = DLocalHelper::createFileInfoByUri(nextUrl, g_file_info_dup(gfileInfo), queryAttributes.toStdString().c_str(),
+        nextUrl = asyncChildUrl(gfileInfo);
+
+        dfileInfoNext = DLocalHelper::createFileInfoByUri(nextUrl, g_file_info_dup(gfileInfo), projectedAttributes(),
                                                           enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
 
         g_object_unref(gfileInfo);
-
-        if (checkFilter())
-            return true;
+        return true;
     }
 
     return false;
@@ -409,7 +608,7 @@ QList<QSharedPointer<DFileInfo>> DEnumeratorPrivate::fileInfoList()
             continue;
         auto url = QUrl::fromLocalFile(uri.path() + "/" + QString(g_file_info_get_name(gfileInfo)));
 
-        infoList.append(DLocalHelper::createFileInfoByUri(url, g_file_info_dup(gfileInfo), queryAttributes.toStdString().c_str(),
+        infoList.append(DLocalHelper::createFileInfoByUri(url, g_file_info_dup(gfileInfo), projectedAttributes(),
                                                           enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone
                                                                     : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks));
         g_object_unref(gfileInfo);
@@ -421,6 +620,68 @@ QList<QSharedPointer<DFileInfo>> DEnumeratorPrivate::fileInfoList()
 void DEnumeratorPrivate::setQueryAttributes(const QString &attributes)
 {
     queryAttributes = attributes;
+    customQueryAttributes = true;
+    updateProjection();
+}
+
+const char *DEnumeratorPrivate::projectedAttributes() const
+{
+    return projection.constData();
+}
+
+void DEnumeratorPrivate::updateProjection()
+{
+    projection = buildProjection();
+}
+
+QByteArray DEnumeratorPrivate::requestedAttributes() const
+{
+    if (customQueryAttributes)
+        return queryAttributes.toUtf8();
+    if (queryAttributeIds.isEmpty())
+        return QByteArray(FILE_DEFAULT_ATTRIBUTES);
+
+    QList<QByteArray> keys;
+    for (const auto id : queryAttributeIds) {
+        // 自定义属性由 standard::name 和 standard::type 计算得到
+        if (id >= DFileInfo::AttributeID::kCustomStart)
+            continue;
+        const char *key = DAttributeTable::key(id);
+        if (*key)
+            keys.append(QByteArray(key));
+    }
+    return keys.join(',');
+}
+
+QByteArray DEnumeratorPrivate::buildProjection() const
+{
+    QList<QByteArray> keys;
+    const QByteArray &requested = requestedAttributes();
+    if (!requested.isEmpty())
+        keys.append(requested);
+
+    // 遍历子目录和过滤器本身需要的属性
+    keys.append(G_FILE_ATTRIBUTE_STANDARD_NAME);
+    keys.append(G_FILE_ATTRIBUTE_STANDARD_TYPE);
+    keys.append(G_FILE_ATTRIBUTE_STANDARD_IS_SYMLINK);
+    if (!dirFilters.testFlag(DEnumerator::DirFilter::kNoFilter)) {
+        if (dirFilters.testFlag(DEnumerator::DirFilter::kAllDirs))
+            keys.append(G_FILE_ATTRIBUTE_STANDARD_SYMLINK_TARGET);
+        if (dirFilters.testFlag(DEnumerator::DirFilter::kReadable))
+            keys.append(G_FILE_ATTRIBUTE_ACCESS_CAN_READ);
+        if (dirFilters.testFlag(DEnumerator::DirFilter::kWritable))
+            keys.append(G_FILE_ATTRIBUTE_ACCESS_CAN_WRITE);
+        if (dirFilters.testFlag(DEnumerator::DirFilter::kExecutable))
+            keys.append(G_FILE_ATTRIBUTE_ACCESS_CAN_EXECUTE);
+    }
+
+    QByteArray attributes;
+    for (const QByteArray &key : keys) {
+        if (!attributes.isEmpty())
+            attributes.append(',');
+        attributes.append(key);
+    }
+    return attributes;
 }
 
 void DEnumeratorPrivate::enumUriAsyncCallBack(GObject *sourceObject, GAsyncResult *res, gpointer userData)
@@ -444,13 +705,8 @@ void DEnumeratorPrivate::enumUriAsyncCallBack(GObject *sourceObject, GAsyncResul
         data->pointer->enumUriAsyncOvered(nullptr);
     } else {
         data->enumerator = enumerator;
-        data->pointer->checkAndResetCancel();
-        g_file_enumerator_next_files_async(enumerator,
-                                           1000,
-                                           G_PRIORITY_DEFAULT,
-                                           data->pointer->cancellable,
-                                           moreFilesCallback,
-                                           data);
+        data->pointer->requestedBatchSize = data->pointer->batchSize;
+        data->pointer->nextFilesAsync(data);
     }
 
     if (error)
@@ -477,15 +733,11 @@ void DEnumeratorPrivate::moreFilesCallback(GObject *sourceObject, GAsyncResult *
     if (error)
         data->pointer->setErrorFromGError(error);
 
+    const int received = static_cast<int>(g_list_length(files));
     data->pointer->enumUriAsyncOvered(files);
     if (files && !error) {
-        data->pointer->checkAndResetCancel();
-        g_file_enumerator_next_files_async(enumerator,
-                                           100,
-                                           G_PRIORITY_DEFAULT,
-                                           data->pointer->cancellable,
-                                           moreFilesCallback,
-                                           data);
+        data->pointer->requestedBatchSize = data->pointer->adaptBatchSize(received);
+        data->pointer->nextFilesAsync(data);
     } else {
         if (!g_file_enumerator_is_closed(data->enumerator)) {
             g_file_enumerator_close_async(data->enumerator,
@@ -499,6 +751,203 @@ void DEnumeratorPrivate::moreFilesCallback(GObject *sourceObject, GAsyncResult *
         g_error_free(error);
 }
 
+quint64 DEnumeratorPrivate::countLocal()
+{
+    if (isParallelEnumerator())
+        return countParallel();
+
+    quint64 count = 0;
+    QStack<LocalDirNode *> nodes;
+    LocalDirNode *root = new LocalDirNode(kCountBufferSize);
+    root->path = uri.toLocalFile().toLocal8Bit();
+    if (!root->reader.open(root->path.constData())) {
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(root->reader.lastErrno())));
+        delete root;
+        return 0;
+    }
+    nodes.push(root);
+    // following links, a link to an ancestor would be walked forever
+    QSet<QPair<quint64, quint64>> visited;
+    if (enumLinks)
+        markVisited(root->reader.fd(), &visited);
+
+    while (!nodes.isEmpty()) {
+        if (localCanceled) {
+            error.setCode(DFMIOErrorCode(DFM_IO_ERROR_CANCELLED));
+            break;
+        }
+
+        LocalDirNode *node = nodes.top();
+        DLocalDirReader::Entry entry;
+        if (!node->reader.next(&entry)) {
+            if (node->reader.lastErrno() != 0)
+                error.setCode(DFMIOErrorCode(g_io_error_from_errno(node->reader.lastErrno())));
+            delete nodes.pop();
+            continue;
+        }
+
+        unsigned char type = entry.type;
+        if (type == DT_UNKNOWN && (enumSubDir || compiledFilter().isEnabled())) {
+            struct statx st;
+            if (node->reader.stat(entry, STATX_TYPE, false, &st))
+                type = DLocalDirReader::typeFromMode(st.stx_mode);
+        }
+
+        if (enumSubDir) {
+            bool isDir = type == DT_DIR;
+            if (type == DT_LNK && enumLinks) {
+                struct statx target;
+                isDir = node->reader.stat(entry, STATX_TYPE, true, &target) && S_ISDIR(target.stx_mode);
+            }
+            if (isDir) {
+                // the large buffer is for the root only, a deep tree holds a buffer per level
+                LocalDirNode *child = new LocalDirNode;
+                if (child->reader.openAt(node->reader.fd(), entry.name) && (!enumLinks || markVisited(child->reader.fd(), &visited))) {
+                    child->path = node->path;
+                    if (!child->path.endsWith('/'))
+                        child->path.append('/');
+                    child->path.append(entry.name, static_cast<int>(entry.nameLength));
+                    nodes.push(child);
+                } else {
+                    delete child;
+                }
+            }
+        }
+
+        if (checkLocalFilter(node->reader.fd(), entry.name, entry.name, entry.nameLength, type, node->path))
+            ++count;
+    }
+
+    while (!nodes.isEmpty())
+        delete nodes.pop();
+    return count;
+}
+
+quint64 DEnumeratorPrivate::countParallel()
+{
+    DLocalParallelWalker::Options options;
+    options.threadCount = threadCount;
+    options.followSymlinks = enumLinks;
+    options.batchSize = 4096;
+
+    DLocalParallelWalker counter(uri.toLocalFile().toLocal8Bit().toStdString(), options);
+    if (!counter.start()) {
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(counter.lastErrno())));
+        return 0;
+    }
+
+    const bool filtered = compiledFilter().isEnabled();
+    quint64 count = 0;
+    DLocalParallelWalker::Batch batch;
+    QByteArray path;
+    while (counter.nextBatch(&batch)) {
+        if (localCanceled) {
+            counter.stop();
+            break;
+        }
+
+        if (!filtered) {
+            count += batch.size();
+            continue;
+        }
+
+        // owned, the filter may cache it beyond this batch
+        const QByteArray dirPath(batch.dirPath.data(), static_cast<int>(batch.dirPath.size()));
+        for (size_t i = 0; i < batch.size(); ++i) {
+            path = dirPath;
+            if (!path.endsWith('/'))
+                path.append('/');
+            const int dirLength = path.size();
+            path.append(batch.name(i));
+            if (checkLocalFilter(AT_FDCWD, path.constData(), path.constData() + dirLength,
+                                 static_cast<size_t>(path.size() - dirLength), batch.types[i], dirPath))
+                ++count;
+        }
+    }
+
+    if (localCanceled)
+        error.setCode(DFMIOErrorCode(DFM_IO_ERROR_CANCELLED));
+    else if (counter.lastErrno() != 0)
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(counter.lastErrno())));
+    return count;
+}
+
+DFileTable DEnumeratorPrivate::readFileTable()
+{
+    if (!fts)
+        openDirByfts();
+
+    DFileTable table(uri);
+    if (!fts)
+        return table;
+
+    const QUrl &urlHidden = QUrl::fromLocalFile(uri.path() + "/.hidden");
+    const QSet<QString> &hideList = DLocalHelper::hideListFromUrl(urlHidden);
+    DFileTablePrivate *tableData = table.d.data();
+    while (1) {
+        FTSENT *ent = fts_read(fts);
+
+        if (ent == nullptr) {
+            break;
+        }
+
+        if (ftsCanceled)
+            break;
+
+        if (ent->fts_level == FTS_ROOTLEVEL || ent->fts_info == FTS_DP)
+            continue;
+
+        const int index = tableData->append(ent, hideList);
+        if (tableData->testFlag(index, DFileTablePrivate::kIsDir) && !tableData->testFlag(index, DFileTablePrivate::kIsSymLink))
+            fts_set(fts, ent, FTS_SKIP);
+    }
+
+    fts_close(fts);
+    fts = nullptr;
+
+    return table;
+}
+
+bool DEnumeratorPrivate::pageSortChanged() const
+{
+    const DFileTablePrivate *table = pageTable->d.constData();
+    return table->sortRole != sortRoleFlag || table->sortOrder != sortOrder
+            || table->sortMixDirAndFile != isMixDirAndFile;
+}
+
+void DEnumeratorPrivate::startPageFill()
+{
+    const DFileTablePrivate *table = pageTable->d.constData();
+    const int from = table->sortedCount;
+    if (from >= table->count())
+        return;
+
+    // columns and keys stay unchanged until the next partialSort(), which waits for this task,
+    // so the tail is sorted without the lock. the order is total, the result agrees with any
+    // prefix sortMore() fixes meanwhile
+    pageCanceled = false;
+    const std::vector<int> tail(table->order.begin() + from, table->order.end());
+    pageFuture = QtConcurrent::run([this, table, from, tail]() {
+        std::vector<int> sorted(tail);
+        std::sort(sorted.begin(), sorted.end(), [table](int left, int right) {
+            return table->lessThan(left, right);
+        });
+
+        QMutexLocker locker(&pageMutex);
+        if (pageCanceled)
+            return;
+        DFileTablePrivate *data = pageTable->d.data();
+        std::copy(sorted.begin(), sorted.end(), data->order.begin() + from);
+        data->sortedCount = data->count();
+    });
+}
+
+void DEnumeratorPrivate::stopPageFill()
+{
+    pageCanceled = true;
+    pageFuture.waitForFinished();
+}
+
 /************************************************
  * DEnumerator
  ***********************************************/
@@ -519,6 +968,7 @@ DEnumerator::DEnumerator(const QUrl &uri, const QStringList &nameFilters, DirFil
 
     d->enumSubDir = d->iteratorFlags & DEnumerator::IteratorFlag::kSubdirectories;
     d->enumLinks = d->iteratorFlags & DEnumerator::IteratorFlag::kFollowSymlinks;
+    d->updateProjection();
 }
 
 DEnumerator::~DEnumerator()
@@ -533,6 +983,7 @@ QUrl DEnumerator::uri() const
 void DEnumerator::setNameFilters(const QStringList &filters)
 {
     d->nameFilters = filters;
+    d->filterDirty = true;
 }
 
 QStringList DEnumerator::nameFilters() const
@@ -543,6 +994,8 @@ QStringList DEnumerator::nameFilters() const
 void DEnumerator::setDirFilters(DirFilters filters)
 {
     d->dirFilters = filters;
+    d->filterDirty = true;
+    d->updateProjection();
 }
 
 DEnumerator::DirFilters DEnumerator::dirFilters() const
@@ -553,6 +1006,9 @@ DEnumerator::DirFilters DEnumerator::dirFilters() const
 void DEnumerator::setIteratorFlags(IteratorFlags flags)
 {
     d->iteratorFlags = flags;
+    d->enumSubDir = d->iteratorFlags & DEnumerator::IteratorFlag::kSubdirectories;
+    d->enumLinks = d->iteratorFlags & DEnumerator::IteratorFlag::kFollowSymlinks;
+    d->filterDirty = true;
 }
 
 DEnumerator::IteratorFlags DEnumerator::iteratorFlags() const
@@ -605,9 +1061,66 @@ void DEnumerator::setQueryAttributes(const QString &attributes)
     return d->setQueryAttributes(attributes);
 }
 
+void DEnumerator::setQueryAttributes(const QList<DFileInfo::AttributeID> &ids)
+{
+    d->queryAttributeIds = ids;
+    d->customQueryAttributes = false;
+    d->updateProjection();
+}
+
 QString DEnumerator::queryAttributes() const
 {
-    return d->queryAttributes;
+    return d->customQueryAttributes ? d->queryAttributes : QString::fromUtf8(d->requestedAttributes());
+}
+
+void DEnumerator::setEnumeratorType(EnumeratorType type)
+{
+    d->enumeratorType = type;
+}
+
+DEnumerator::EnumeratorType DEnumerator::enumeratorType() const
+{
+    return d->enumeratorType;
+}
+
+void DEnumerator::setThreadCount(int count)
+{
+    d->threadCount = qMax(1, count);
+}
+
+int DEnumerator::threadCount() const
+{
+    return d->threadCount;
+}
+
+void DEnumerator::setOrderedResults(bool ordered)
+{
+    d->orderedResults = ordered;
+}
+
+bool DEnumerator::isOrderedResults() const
+{
+    return d->orderedResults;
+}
+
+void DEnumerator::setBatchSize(int size)
+{
+    d->batchSize = qMax(1, size);
+}
+
+int DEnumerator::batchSize() const
+{
+    return d->batchSize;
+}
+
+void DEnumerator::setAdaptiveBatchSize(bool adaptive)
+{
+    d->adaptiveBatchSize = adaptive;
+}
+
+bool DEnumerator::isAdaptiveBatchSize() const
+{
+    return d->adaptiveBatchSize;
 }
 
 bool DEnumerator::cancel()
@@ -615,7 +1128,10 @@ bool DEnumerator::cancel()
     if (d->cancellable && !g_cancellable_is_cancelled(d->cancellable))
         g_cancellable_cancel(d->cancellable);
     d->ftsCanceled = true;
+    d->localCanceled = true;
     d->asyncStoped = true;
+    if (d->walker)
+        d->walker->stop();
     return true;
 }
 
@@ -627,6 +1143,12 @@ bool DEnumerator::hasNext() const
     if (!d->inited)
         d->init();
 
+    if (d->isParallelEnumerator())
+        return d->hasNextParallel();
+
+    if (d->isLocalEnumerator())
+        return d->hasNextLocal();
+
     while (!d->stackEnumerator.isEmpty()) {
         GFileEnumerator *enumerator = d->stackEnumerator.top();
         GFileInfo *gfileInfo = nullptr;
@@ -641,9 +1163,17 @@ bool DEnumerator::hasNext() const
                 // 当前枚举器已完成，弹出并继续下一个
                 GFileEnumerator *enumeratorPop = d->stackEnumerator.pop();
                 g_object_unref(enumeratorPop);
+                d->hideListOwner = nullptr;
                 continue;
             }
 
+            // 如果是目录且需要遍历子目录
+            const bool enterDir = d->enumSubDir && g_file_info_get_file_type(gfileInfo) == G_FILE_TYPE_DIRECTORY
+                    && (!g_file_info_get_is_symlink(gfileInfo) || d->enumLinks);
+            const bool accepted = d->checkFilter(gfileInfo, g_file_enumerator_get_container(enumerator));
+            if (!enterDir && !accepted)
+                continue;
+
             g_autofree gchar *path = g_file_get_path(gfile);
             if (path) {
                 d->nextUrl = QUrl::fromLocalFile(QString::fromLocal8Bit(path));
@@ -651,23 +1181,15 @@ bool DEnumerator::hasNext() const
                 g_autofree gchar *uri = g_file_get_uri(gfile);
                 d->nextUrl = QUrl(QString::fromLocal8Bit(uri));
             }
-            d->dfileInfoNext = DLocalHelper::createFileInfoByUri(d->nextUrl, g_file_info_dup(gfileInfo), FILE_DEFAULT_ATTRIBUTES,
-                                                                 d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
 
-            // 如果是目录且需要遍历子目录
-            if (d->enumSubDir && d->dfileInfoNext && d->dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool()) {
-                bool showDir = true;
-                if (d->dfileInfoNext->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool()) {
-                    showDir = d->enumLinks;
-                }
-                if (showDir) {
-                    d->init(d->nextUrl);
-                }
-            }
+            if (enterDir)
+                d->init(d->nextUrl);
 
-            if (!d->checkFilter())
+            if (!accepted)
                 continue;
 
+            d->dfileInfoNext = DLocalHelper::createFileInfoByUri(d->nextUrl, g_file_info_dup(gfileInfo), d->projectedAttributes(),
+                                                                 d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
             return true;
         }
 
@@ -679,6 +1201,7 @@ bool DEnumerator::hasNext() const
         // 当前枚举器已完成，弹出并继续下一个
         GFileEnumerator *enumeratorPop = d->stackEnumerator.pop();
         g_object_unref(enumeratorPop);
+        d->hideListOwner = nullptr;
     }
 
     return false;
@@ -686,16 +1209,26 @@ bool DEnumerator::hasNext() const
 
 QUrl DEnumerator::next() const
 {
+    if (d->nextUrl.isEmpty() && !d->nextPath.isEmpty())
+        d->nextUrl = QUrl::fromLocalFile(QString::fromLocal8Bit(d->nextPath));
     return d->nextUrl;
 }
 
 QSharedPointer<DFileInfo> DEnumerator::fileInfo() const
 {
+    // system enumerator creates file info only when it is really needed
+    if (!d->dfileInfoNext && !d->nextPath.isEmpty())
+        d->dfileInfoNext = DLocalHelper::createFileInfoByUri(next(), d->projectedAttributes(),
+                                                             d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
     return d->dfileInfoNext;
 }
 
 quint64 DEnumerator::fileCount()
 {
+    // a fresh local enumerator counts raw dirents, no GFileInfo/DFileInfo/QUrl per entry
+    if (!d->inited && !d->async && d->uri.isLocalFile())
+        return d->countLocal();
+
     if (!d->inited)
         d->init();
 
@@ -719,7 +1252,7 @@ QList<QSharedPointer<DFileInfo>> DEnumerator::fileInfoList()
 
     d->checkAndResetCancel();
     enumerator = g_file_enumerate_children(gfile,
-                                           FILE_DEFAULT_ATTRIBUTES,
+                                           d->projectedAttributes(),
                                            d->enumLinks ? G_FILE_QUERY_INFO_NONE : G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS,
                                            d->cancellable,
                                            &gerror);
@@ -741,7 +1274,8 @@ QList<QSharedPointer<DFileInfo>> DEnumerator::fileInfoList()
 
         g_autofree gchar *uri = g_file_get_uri(gfileIn);
         const QUrl &url = QUrl(QString::fromLocal8Bit(uri));
-        QSharedPointer<DFileInfo> info = DLocalHelper::createFileInfoByUri(url);
+        QSharedPointer<DFileInfo> info = DLocalHelper::createFileInfoByUri(url, g_file_info_dup(gfileInfoIn), d->projectedAttributes(),
+                                                                           d->enumLinks ? DFileInfo::FileQueryInfoFlags::kTypeNone : DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
         if (info)
             d->infoList.append(info);
 
@@ -759,43 +1293,76 @@ QList<QSharedPointer<DFileInfo>> DEnumerator::fileInfoList()
 
 QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumerator::sortFileInfoList()
 {
-    if (!d->fts)
-        d->openDirByfts();
-
-    if (!d->fts)
-        return {};
-
-    QList<QSharedPointer<DEnumerator::SortFileInfo>> listFile;
-    QList<QSharedPointer<DEnumerator::SortFileInfo>> listDir;
-    QSet<QString> hideList;
-    const QUrl &urlHidden = QUrl::fromLocalFile(d->uri.path() + "/.hidden");
-    hideList = DLocalHelper::hideListFromUrl(urlHidden);
-    while (1) {
-        FTSENT *ent = fts_read(d->fts);
-
-        if (ent == nullptr) {
-            break;
-        }
+    return sortFileTable().toSortFileInfoList();
+}
 
-        if (d->ftsCanceled)
-            break;
+DFileTable DEnumerator::sortFileTable()
+{
+    DFileTable table = d->readFileTable();
+    table.sort(d->sortRoleFlag, d->sortOrder, d->isMixDirAndFile);
+    return table;
+}
 
-        unsigned short flag = ent->fts_info;
+QList<QSharedPointer<DEnumerator::SortFileInfo>> DEnumerator::sortFileInfoPage(int offset, int count)
+{
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> page;
+    if (offset < 0 || count <= 0)
+        return page;
+
+    const int end = static_cast<int>(qMin<qint64>(qint64(offset) + count, std::numeric_limits<int>::max()));
+    if (!d->pageTable) {
+        d->pageTable.reset(new DFileTable(d->readFileTable()));
+        d->pageTable->partialSort(d->sortRoleFlag, d->sortOrder, d->isMixDirAndFile, end);
+        d->startPageFill();
+    } else if (d->pageSortChanged()) {
+        // same entries, only the order is selected again
+        d->stopPageFill();
+        d->pageTable->partialSort(d->sortRoleFlag, d->sortOrder, d->isMixDirAndFile, end);
+        d->startPageFill();
+    } else {
+        QMutexLocker locker(&d->pageMutex);
+        d->pageTable->sortMore(end);
+    }
 
-        if (QString(ent->fts_path) == d->uri.path() || flag == FTS_DP)
-            continue;
+    QMutexLocker locker(&d->pageMutex);
+    const int last = qMin(end, d->pageTable->count());
+    for (int pos = offset; pos < last; ++pos)
+        page.append(d->pageTable->row(pos).toSortFileInfo());
+    return page;
+}
 
-        d->insertSortFileInfoList(listFile, listDir, ent, d->fts, hideList);
+DDirSnapshot DEnumerator::snapshot()
+{
+    DDirSnapshot snapshot;
+    if (!d->uri.isLocalFile()) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+        return snapshot;
     }
 
-    fts_close(d->fts);
-    d->fts = nullptr;
+    DDirSnapshotPrivate *data = snapshot.d.data();
+    data->dirUrl = d->uri;
+    data->dirPath = d->uri.toLocalFile().toLocal8Bit();
+    const int err = data->scan(nullptr, d->localCanceled);
+    if (err != 0)
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(err)));
+    return snapshot;
+}
 
-    if (d->isMixDirAndFile)
-        return listFile;
+DDirSnapshot::Delta DEnumerator::diff(DDirSnapshot &snapshot)
+{
+    DDirSnapshot::Delta delta;
+    if (!snapshot.isValid() || snapshot.dirUrl() != d->uri) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+        return delta;
+    }
 
-    listDir.append(listFile);
-    return listDir;
+    // scan() keeps the old entries if the directory can't be read completely
+    const int err = snapshot.d->scan(&delta, d->localCanceled);
+    if (err != 0) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(err)));
+        return {};
+    }
+    return delta;
 }
 
 DFMIOError DEnumerator::lastError() const
@@ -808,6 +1375,7 @@ DEnumeratorFuture *DEnumerator::asyncIterator()
     d->async = true;
     DEnumeratorFuture *future = new DEnumeratorFuture(sharedFromThis());
     QObject::connect(d.data(), &DEnumeratorPrivate::asyncIteratorOver, future, &DEnumeratorFuture::onAsyncIteratorOver);
+    QObject::connect(d.data(), &DEnumeratorPrivate::asyncBatchReady, future, &DEnumeratorFuture::onBatchReady);
     return future;
 }
 
@@ -50,3 +50,8 @@ void DEnumeratorFuture::onAsyncIteratorOver()
 {
     Q_EMIT asyncIteratorOver();
 }
+
+void DEnumeratorFuture::onBatchReady(const QList<QSharedPointer<DFileInfo>> &infos)
+{
+    Q_EMIT batchReady(infos);
+}
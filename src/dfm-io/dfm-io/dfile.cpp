@@ -3,7 +3,9 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "private/dfile_p.h"
-#include "utils/dlocalhelper.h"
+#include "private/dfilemapping_p.h"
+#include "utils/dattributetable.h"
+#include "utils/duringengine.h"
 
 #include <dfm-io/dfilefuture.h>
 
@@ -12,8 +14,15 @@
 #include <QDebug>
 
 #include <gio/gio.h>
+#include <gio-unix-2.0/gio/gfiledescriptorbased.h>
 
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <memory>
 
 USING_IO_NAMESPACE
 
@@ -84,8 +93,8 @@ DFile::Permissions DFilePrivate::permissionsFromGFileInfo(GFileInfo *gfileinfo)
     if (!gfileinfo)
         return retValue;
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    const quint32 &stMode = g_file_info_get_attribute_uint32(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kUnixMode>();
+    const quint32 &stMode = g_file_info_get_attribute_uint32(gfileinfo, attributeKey);
     if (!stMode)
         return retValue;
 
@@ -185,6 +194,81 @@ quint32 DFilePrivate::buildPermissions(DFile::Permissions permission)
     return stMode;
 }
 
+int DFilePrivate::streamFd(gpointer stream)
+{
+    if (!stream || !G_IS_FILE_DESCRIPTOR_BASED(stream))
+        return -1;
+    return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(stream));
+}
+
+DUringEngine *DFilePrivate::uringEngine(gpointer stream, int *fd) const
+{
+    if (asyncEngine != DFile::AsyncEngine::kIoUring)
+        return nullptr;
+
+    *fd = streamFd(stream);
+    if (*fd < 0)
+        return nullptr;
+    return DUringEngine::instance();
+}
+
+int DFilePrivate::adviceFd(bool openOnly, int *ownFd)
+{
+    *ownFd = -1;
+    int fd = streamFd(inputStream());
+    if (fd < 0)
+        fd = streamFd(outputStream());
+    if (fd >= 0 || openOnly || !uri.isLocalFile())
+        return fd;
+
+    // page cache hints are per inode, any fd of the file will do
+    *ownFd = ::open(uri.toLocalFile().toLocal8Bit().constData(), O_RDONLY | O_CLOEXEC);
+    if (*ownFd < 0)
+        error.setCode(DFMIOErrorCode(g_io_error_from_errno(errno)));
+    return *ownFd;
+}
+
+void DFilePrivate::setPositionalError(DFMIOErrorCode code)
+{
+    std::lock_guard<std::mutex> locker(errorLock);
+    error.setCode(code);
+}
+
+qint64 DFilePrivate::doPositional(bool write, qint64 offset, const DFile::Segment *segments, int count)
+{
+    gpointer stream = write ? static_cast<gpointer>(outputStream()) : static_cast<gpointer>(inputStream());
+    if (!stream) {
+        setPositionalError(DFMIOErrorCode::DFM_IO_ERROR_OPEN_FAILED);
+        return -1;
+    }
+    const int fd = streamFd(stream);
+    if (fd < 0) {
+        // gvfs streams only know seek() plus read()
+        setPositionalError(DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+        return -1;
+    }
+    // pwrite(2) on an O_APPEND fd ignores the offset and writes at the end
+    if (offset < 0 || count < 0 || count > IOV_MAX || (write && (fcntl(fd, F_GETFL) & O_APPEND))) {
+        setPositionalError(DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+        return -1;
+    }
+
+    struct iovec vectors[IOV_MAX];
+    for (int i = 0; i < count; ++i) {
+        vectors[i].iov_base = segments[i].data;
+        vectors[i].iov_len = static_cast<size_t>(qMax<qint64>(0, segments[i].size));
+    }
+
+    ssize_t ret = -1;
+    do {
+        ret = write ? pwritev(fd, vectors, count, static_cast<off_t>(offset))
+                    : preadv(fd, vectors, count, static_cast<off_t>(offset));
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0)
+        setPositionalError(DFMIOErrorCode(g_io_error_from_errno(errno)));
+    return ret;
+}
+
 bool DFilePrivate::doOpen(DFile::OpenFlags mode)
 {
     if (q->isOpen()) {
@@ -530,8 +614,8 @@ void DFilePrivate::existsAsyncCallback(GObject *sourceObject, GAsyncResult *res,
         return;
     }
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
-    const quint32 exists = g_file_info_get_attribute_uint32(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kStandardType>();
+    const quint32 exists = g_file_info_get_attribute_uint32(gfileinfo, attributeKey);
 
     future->infoExists(exists != G_FILE_TYPE_UNKNOWN);
     future->finished();
@@ -562,8 +646,8 @@ void DFilePrivate::sizeAsyncCallback(GObject *sourceObject, GAsyncResult *res, g
         return;
     }
 
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
-    const quint64 size = g_file_info_get_attribute_uint64(gfileinfo, attributeKey.c_str());
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kStandardSize>();
+    const quint64 size = g_file_info_get_attribute_uint64(gfileinfo, attributeKey);
 
     future->infoSize(size);
     future->finished();
@@ -641,6 +725,119 @@ void DFilePrivate::readAsyncFutureCallback(GObject *sourceObject, GAsyncResult *
     g_free(data);
 }
 
+// an io_uring request of DFile. as the async calls of GIO do, it holds the pending flag of the stream until the
+// result is reported, so overlapping calls and close() fail. the refs keep the stream and its fd alive meanwhile
+struct UringOp
+{
+    ~UringOp()
+    {
+        if (ioStream)
+            g_object_unref(ioStream);
+        g_object_unref(stream);
+        g_main_context_unref(context);
+    }
+
+    QPointer<DFilePrivate> me;
+    DUringEngine *engine { nullptr };
+    gpointer stream { nullptr };
+    GIOStream *ioStream { nullptr };
+    GMainContext *context { nullptr };
+    int fd { -1 };
+    // the request runs at an explicit offset, the file position is moved past it when the result is reported.
+    // -1 for append streams, the kernel writes at the end
+    qint64 offset { -1 };
+    // the future variant of read: chunks of registered buffers until remaining or the end of the file
+    quint64 remaining { 0 };
+    QByteArray data;
+};
+
+static void uringClearPending(UringOp *op)
+{
+    if (G_IS_INPUT_STREAM(op->stream))
+        g_input_stream_clear_pending(G_INPUT_STREAM(op->stream));
+    else
+        g_output_stream_clear_pending(G_OUTPUT_STREAM(op->stream));
+    if (op->me)
+        --op->me->uringPending;
+}
+
+// nullptr and error set if another request of the stream is pending
+static std::shared_ptr<UringOp> uringBegin(DFilePrivate *d, DUringEngine *engine, gpointer stream, int fd)
+{
+    g_autoptr(GError) gerror = nullptr;
+    const bool set = G_IS_INPUT_STREAM(stream) ? g_input_stream_set_pending(G_INPUT_STREAM(stream), &gerror)
+                                               : g_output_stream_set_pending(G_OUTPUT_STREAM(stream), &gerror);
+    if (!set) {
+        d->setErrorFromGError(gerror);
+        return nullptr;
+    }
+
+    auto op = std::make_shared<UringOp>();
+    op->me = d;
+    op->engine = engine;
+    op->stream = g_object_ref(stream);
+    // the GIOStream closes the fd when it is disposed, whatever its substreams are doing
+    op->ioStream = d->ioStream ? G_IO_STREAM(g_object_ref(d->ioStream)) : nullptr;
+    op->context = g_main_context_ref_thread_default();
+    op->fd = fd;
+    const int flags = fcntl(fd, F_GETFL);
+    op->offset = (flags < 0 || (flags & O_APPEND)) ? -1 : lseek(fd, 0, SEEK_CUR);
+    ++d->uringPending;
+    return op;
+}
+
+// the request was not submitted, the caller falls back to GIO
+static void uringAbort(const std::shared_ptr<UringOp> &op)
+{
+    uringClearPending(op.get());
+}
+
+// called in the reaping thread when a request is done, bytes is what it transferred.
+// report runs in the thread that started the request, after the pending flag is cleared
+static void uringEnd(const std::shared_ptr<UringOp> &op, qint64 bytes, std::function<void()> report)
+{
+    if (bytes > 0 && op->offset >= 0)
+        op->offset += bytes;
+    DUringEngine::post(op->context, [op, report]() {
+        if (op->offset >= 0)
+            lseek(op->fd, op->offset, SEEK_SET);
+        uringClearPending(op.get());
+        report();
+    });
+}
+
+static bool uringReadNext(const std::shared_ptr<UringOp> &op, QPointer<DFileFuture> future)
+{
+    const size_t length = static_cast<size_t>(qMin<quint64>(op->remaining, DUringEngine::kFixedBufferSize));
+    const qint64 offset = op->offset < 0 ? -1 : op->offset + op->data.size();
+    return op->engine->readFixed(op->fd, length, offset, [op, future, length](qint64 result, const char *buffer) {
+        if (result < 0) {
+            const DFMIOError error(DFMIOErrorCode(g_io_error_from_errno(static_cast<int>(-result))));
+            uringEnd(op, op->data.size(), [op, future, error]() {
+                if (op->me)
+                    op->me->setError(error);
+                if (future) {
+                    future->setError(error);
+                    future->finished();
+                }
+            });
+            return;
+        }
+
+        // copied here, the registered buffer is reused once this returns
+        op->data.append(buffer, static_cast<int>(result));
+        op->remaining -= static_cast<quint64>(result);
+        if (static_cast<size_t>(result) == length && op->remaining > 0 && uringReadNext(op, future))
+            return;
+        uringEnd(op, op->data.size(), [op, future]() {
+            if (future) {
+                future->readData(op->data);
+                future->finished();
+            }
+        });
+    });
+}
+
 /************************************************
  * DFile
  ***********************************************/
@@ -659,7 +856,9 @@ DFile::DFile(const QString &path)
 
 DFile::~DFile()
 {
-    close();
+    // io_uring requests still running hold refs of the streams, the fd is closed after the last one
+    if (d->isOpen)
+        d->doClose();
 }
 
 QUrl DFile::uri() const
@@ -751,10 +950,8 @@ DFile::Permissions DFile::permissions() const
 
     g_autoptr(GError) gerror = nullptr;
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    if (attributeKey.empty())
-        return retValue;
-    g_autoptr(GFileInfo) fileInfo = g_file_query_info(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, d->cancellable, &gerror);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kUnixMode>();
+    g_autoptr(GFileInfo) fileInfo = g_file_query_info(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, d->cancellable, &gerror);
 
     if (gerror)
         d->setErrorFromGError(gerror);
@@ -767,6 +964,7 @@ DFile::Permissions DFile::permissions() const
 
 DFMIOError DFile::lastError() const
 {
+    std::lock_guard<std::mutex> locker(d->errorLock);
     return d->error;
 }
 
@@ -779,6 +977,10 @@ bool DFile::open(DFile::OpenFlags mode)
 
 bool DFile::close()
 {
+    if (d->uringPending > 0) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_PENDING);
+        return false;
+    }
     if (d->isOpen) {
         if (d->doClose())
             d->isOpen = false;
@@ -909,8 +1111,8 @@ bool DFile::setPermissions(Permissions permission)
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     g_autoptr(GError) gerror = nullptr;
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    bool succ = g_file_set_attribute_uint32(gfile, attributeKey.c_str(), stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kUnixMode>();
+    bool succ = g_file_set_attribute_uint32(gfile, attributeKey, stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
     if (gerror)
         d->setErrorFromGError(gerror);
     return succ;
@@ -1009,6 +1211,156 @@ qint64 DFile::write(const QByteArray &byteArray)
     return d->doWrite(byteArray);
 }
 
+bool DFile::advise(AccessHint hint, qint64 offset, qint64 length)
+{
+    if (!d->uri.isLocalFile())
+        return true;
+    if (offset < 0 || length < 0) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+        return false;
+    }
+
+    int advice = POSIX_FADV_NORMAL;
+    switch (hint) {
+    case AccessHint::kSequential:
+        advice = POSIX_FADV_SEQUENTIAL;
+        break;
+    case AccessHint::kRandom:
+        advice = POSIX_FADV_RANDOM;
+        break;
+    case AccessHint::kNoReuse:
+        advice = POSIX_FADV_NOREUSE;
+        break;
+    case AccessHint::kWillNeed:
+        advice = POSIX_FADV_WILLNEED;
+        break;
+    case AccessHint::kDontNeed:
+        advice = POSIX_FADV_DONTNEED;
+        break;
+    default:
+        break;
+    }
+
+    const bool pageCacheOnly = hint == AccessHint::kWillNeed || hint == AccessHint::kDontNeed;
+    int ownFd = -1;
+    const int fd = d->adviceFd(!pageCacheOnly, &ownFd);
+    if (fd < 0) {
+        if (!pageCacheOnly)
+            d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_OPEN_FAILED);
+        return false;
+    }
+
+    // dirty pages are not dropped, write them back first
+    if (hint == AccessHint::kDontNeed && d->outputStream())
+        sync_file_range(fd, offset, length, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+
+    const int ret = posix_fadvise(fd, offset, length, advice);
+    if (ownFd >= 0)
+        ::close(ownFd);
+    if (ret != 0) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(ret)));
+        return false;
+    }
+    return true;
+}
+
+bool DFile::readahead(qint64 offset, qint64 length)
+{
+    if (!d->uri.isLocalFile())
+        return true;
+    if (offset < 0 || length < 0) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+        return false;
+    }
+
+    int ownFd = -1;
+    const int fd = d->adviceFd(false, &ownFd);
+    if (fd < 0)
+        return false;
+
+    const bool ok = ::readahead(fd, offset, static_cast<size_t>(length)) == 0;
+    if (!ok)
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(errno)));
+    if (ownFd >= 0)
+        ::close(ownFd);
+    return ok;
+}
+
+qint64 DFile::readAt(qint64 offset, char *data, qint64 maxSize) const
+{
+    const Segment segment { data, maxSize };
+    return d->doPositional(false, offset, &segment, 1);
+}
+
+qint64 DFile::writeAt(qint64 offset, const char *data, qint64 len)
+{
+    // pwrite does not write through the pointer
+    const Segment segment { const_cast<char *>(data), len };
+    return d->doPositional(true, offset, &segment, 1);
+}
+
+qint64 DFile::readv(qint64 offset, const Segment *segments, int count) const
+{
+    return d->doPositional(false, offset, segments, count);
+}
+
+qint64 DFile::writev(qint64 offset, const Segment *segments, int count)
+{
+    return d->doPositional(true, offset, segments, count);
+}
+
+void DFile::setAsyncEngine(AsyncEngine engine)
+{
+    d->asyncEngine = engine;
+}
+
+DFile::AsyncEngine DFile::asyncEngine() const
+{
+    return d->asyncEngine;
+}
+
+DFileMapping DFile::map(qint64 offset, qint64 size, DFileMapping::Advice advice)
+{
+    DFileMapping mapping;
+    if (!d->uri.isLocalFile()) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+        return mapping;
+    }
+
+    // an fd of its own, the mapping does not depend on the stream and outlives close()
+    const QByteArray &path = d->uri.toLocalFile().toLocal8Bit();
+    const int fd = ::open(path.constData(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(errno)));
+        return mapping;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(errno)));
+        ::close(fd);
+        return mapping;
+    }
+    if (!S_ISREG(st.st_mode) || offset < 0 || offset > st.st_size || size < -1 || (size > st.st_size - offset)) {
+        d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+        ::close(fd);
+        return mapping;
+    }
+    if (size == -1)
+        size = st.st_size - offset;
+
+    const int ret = mapping.d->map(fd, offset, size);
+    ::close(fd);
+    if (ret != 0) {
+        d->error.setCode(DFMIOErrorCode(g_io_error_from_errno(ret)));
+        return mapping;
+    }
+
+    if (advice != DFileMapping::Advice::kNormal)
+        mapping.advise(advice);
+    return mapping;
+}
+
 void DFile::readAsync(char *data, qint64 maxSize, int ioPriority, DFile::ReadCallbackFunc func, void *userData)
 {
     GInputStream *inputStream = d->inputStream();
@@ -1019,6 +1371,24 @@ void DFile::readAsync(char *data, qint64 maxSize, int ioPriority, DFile::ReadCal
         return;
     }
 
+    int fd = -1;
+    if (DUringEngine *engine = d->uringEngine(inputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, inputStream, fd);
+        if (!op) {
+            if (func)
+                func(-1, userData);
+            return;
+        }
+        if (engine->read(fd, data, static_cast<size_t>(maxSize), op->offset, [op, func, userData](qint64 result, const char *) {
+                uringEnd(op, result, [func, userData, result]() {
+                    if (func)
+                        func(result < 0 ? -1 : result, userData);
+                });
+            }))
+            return;
+        uringAbort(op);
+    }
+
     DFilePrivate::ReadAsyncOp *dataOp = g_new0(DFilePrivate::ReadAsyncOp, 1);
     dataOp->callback = func;
     dataOp->userData = userData;
@@ -1043,6 +1413,36 @@ void DFile::readQAsync(qint64 maxSize, int ioPriority, DFile::ReadQCallbackFunc
         return;
     }
 
+    int fd = -1;
+    if (DUringEngine *engine = d->uringEngine(inputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, inputStream, fd);
+        if (!op) {
+            if (func)
+                func(QByteArray(), userData);
+            return;
+        }
+        // copied in the reaping thread, the registered buffer is reused once done returns
+        auto done = [op, func, userData](qint64 result, const char *buffer) {
+            const QByteArray data = result < 0 ? QByteArray() : QByteArray(buffer, static_cast<int>(result));
+            uringEnd(op, result, [func, userData, data]() {
+                if (func)
+                    func(data, userData);
+            });
+        };
+        bool submitted = false;
+        if (static_cast<size_t>(maxSize) <= DUringEngine::kFixedBufferSize) {
+            submitted = engine->readFixed(fd, static_cast<size_t>(maxSize), op->offset, done);
+        } else {
+            std::shared_ptr<char> buffer(new char[static_cast<size_t>(maxSize)], std::default_delete<char[]>());
+            submitted = engine->read(fd, buffer.get(), static_cast<size_t>(maxSize), op->offset, [buffer, done](qint64 result, const char *data) {
+                done(result, data);
+            });
+        }
+        if (submitted)
+            return;
+        uringAbort(op);
+    }
+
     char data[maxSize + 1];
     memset(&data, 0, maxSize + 1);
 
@@ -1103,6 +1503,24 @@ void DFile::writeAsync(const char *data, qint64 maxSize, int ioPriority, DFile::
         return;
     }
 
+    int fd = -1;
+    if (DUringEngine *engine = d->uringEngine(outputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, outputStream, fd);
+        if (!op) {
+            if (func)
+                func(-1, userData);
+            return;
+        }
+        if (engine->write(fd, data, static_cast<size_t>(maxSize), op->offset, [op, func, userData](qint64 result, const char *) {
+                uringEnd(op, result, [func, userData, result]() {
+                    if (func)
+                        func(result < 0 ? -1 : result, userData);
+                });
+            }))
+            return;
+        uringAbort(op);
+    }
+
     DFilePrivate::WriteAsyncOp *dataOp = g_new0(DFilePrivate::WriteAsyncOp, 1);
     dataOp->callback = func;
     dataOp->userData = userData;
@@ -1124,6 +1542,27 @@ void DFile::writeAllAsync(const char *data, int ioPriority, DFile::WriteAllCallb
 
 void DFile::writeQAsync(const QByteArray &byteArray, int ioPriority, DFile::WriteQCallbackFunc func, void *userData)
 {
+    int fd = -1;
+    GOutputStream *outputStream = d->outputStream();
+    if (DUringEngine *engine = d->uringEngine(outputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, outputStream, fd);
+        if (!op) {
+            if (func)
+                func(-1, userData);
+            return;
+        }
+        // the copy shares the data and keeps it alive until the write is done
+        const QByteArray held = byteArray;
+        if (engine->write(fd, held.constData(), static_cast<size_t>(held.size()), op->offset, [op, held, func, userData](qint64 result, const char *) {
+                uringEnd(op, result, [func, userData, result]() {
+                    if (func)
+                        func(result < 0 ? -1 : result, userData);
+                });
+            }))
+            return;
+        uringAbort(op);
+    }
+
     writeAsync(byteArray.data(), byteArray.length(), ioPriority, func, userData);
 }
 
@@ -1169,6 +1608,20 @@ DFileFuture *DFile::readAsync(quint64 maxSize, int ioPriority, QObject *parent)
         return future;
     }
 
+    int fd = -1;
+    if (DUringEngine *engine = d->uringEngine(inputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, inputStream, fd);
+        if (!op) {
+            future->setError(d->error);
+            return future;
+        }
+        // the pending flag is held for the whole chain of reads
+        op->remaining = maxSize;
+        if (uringReadNext(op, future))
+            return future;
+        uringAbort(op);
+    }
+
     QByteArray data;
     DFilePrivate::ReadAllAsyncFutureOp *dataOp = g_new0(DFilePrivate::ReadAllAsyncFutureOp, 1);
     dataOp->me = d.data();
@@ -1201,6 +1654,37 @@ DFileFuture *DFile::writeAsync(const QByteArray &data, qint64 len, int ioPriorit
         return future;
     }
 
+    int fd = -1;
+    if (DUringEngine *engine = d->uringEngine(outputStream, &fd)) {
+        auto op = uringBegin(d.data(), engine, outputStream, fd);
+        if (!op) {
+            future->setError(d->error);
+            return future;
+        }
+        QPointer<DFileFuture> target = future;
+        const QByteArray held = data;
+        if (engine->write(fd, held.constData(), static_cast<size_t>(qBound<qint64>(0, len, held.size())), op->offset, [op, target, held](qint64 result, const char *) {
+                uringEnd(op, result, [op, target, result]() {
+                    if (result < 0) {
+                        const DFMIOError error(DFMIOErrorCode(g_io_error_from_errno(static_cast<int>(-result))));
+                        if (op->me)
+                            op->me->setError(error);
+                        if (target) {
+                            target->setError(error);
+                            target->finished();
+                        }
+                        return;
+                    }
+                    if (target) {
+                        target->writeAsyncSize(result);
+                        target->finished();
+                    }
+                });
+            }))
+            return future;
+        uringAbort(op);
+    }
+
     DFilePrivate::NormalFutureAsyncOp *dataOp = g_new0(DFilePrivate::NormalFutureAsyncOp, 1);
     dataOp->me = d.data();
     dataOp->future = future;
@@ -1252,8 +1736,8 @@ DFileFuture *DFile::sizeAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardSize);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, DFilePrivate::sizeAsyncCallback, data);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kStandardSize>();
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, DFilePrivate::sizeAsyncCallback, data);
 
     return future;
 }
@@ -1268,8 +1752,8 @@ DFileFuture *DFile::existsAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kStandardType);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->existsAsyncCallback, data);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kStandardType>();
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->existsAsyncCallback, data);
 
     return future;
 }
@@ -1284,8 +1768,8 @@ DFileFuture *DFile::permissionsAsync(int ioPriority, QObject *parent)
 
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
-    g_file_query_info_async(gfile, attributeKey.c_str(), G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->permissionsAsyncCallback, data);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kUnixMode>();
+    g_file_query_info_async(gfile, attributeKey, G_FILE_QUERY_INFO_NONE, ioPriority, d->cancellable, d->permissionsAsyncCallback, data);
 
     return future;
 }
@@ -1300,11 +1784,11 @@ DFileFuture *DFile::setPermissionsAsync(Permissions permission, int ioPriority,
     g_autoptr(GFile) gfile = g_file_new_for_uri(d->uri.toString().toStdString().c_str());
     d->checkAndResetCancel();
     g_autoptr(GError) gerror = nullptr;
-    const std::string &attributeKey = DLocalHelper::attributeStringById(DFileInfo::AttributeID::kUnixMode);
+    const char *attributeKey = DAttributeTable::keyOf<DFileInfo::AttributeID::kUnixMode>();
 
     QPointer<DFilePrivate> me = d.data();
     QtConcurrent::run([&]() {
-        g_file_set_attribute_uint32(gfile, attributeKey.c_str(), stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
+        g_file_set_attribute_uint32(gfile, attributeKey, stMode, G_FILE_QUERY_INFO_NOFOLLOW_SYMLINKS, d->cancellable, &gerror);
         if (!me)
             return;
         if (gerror)
@@ -5,7 +5,9 @@
 #include "private/dfileinfo_p.h"
 
 #include "utils/dmediainfo.h"
+#include "utils/dmediainfocache.h"
 #include "utils/dlocalhelper.h"
+#include "utils/dattributetable.h"
 
 #include <dfm-io/dfilefuture.h>
 
@@ -16,11 +18,26 @@
 #include <QThread>
 
 #include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <fcntl.h>
 #include <execinfo.h>
+#include <string.h>
+
+#include <algorithm>
 
 USING_IO_NAMESPACE
 
+// get<id>() returns the type DFileInfo::attributeType() names, the table must read the same type from GIO
+static constexpr bool attributeTypesMatch()
+{
+    for (const auto &desc : kAttributeDescriptors) {
+        if (desc.id < DFileInfo::AttributeID::kCustomStart && DFileInfo::attributeType(desc.id) != desc.type)
+            return false;
+    }
+    return true;
+}
+static_assert(attributeTypesMatch(), "DFileInfo::attributeType() does not match the attribute table");
+
 /************************************************
  * DFileInfoPrivate
  ***********************************************/
@@ -106,6 +123,11 @@ DFileInfoPrivate::~DFileInfoPrivate()
         g_object_unref(gcancellable);
         gcancellable = nullptr;
     }
+
+    if (queriedMatcher) {
+        g_file_attribute_matcher_unref(queriedMatcher);
+        queriedMatcher = nullptr;
+    }
 }
 
 void DFileInfoPrivate::initNormal()
@@ -131,8 +153,18 @@ void DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInf
             extendIDs = ids;
             attributeExtendFuncCallback = callback;
 
+            QMap<DFileInfo::AttributeExtendID, QVariant> map;
+            if (cachedMediaValues(filePath, &map)) {
+                // never before attributeExtend() returns, as when the values are read
+                if (callback)
+                    QMetaObject::invokeMethod(this, [callback, map]() {
+                        callback(true, map);
+                    }, Qt::QueuedConnection);
+                return;
+            }
+
             this->mediaInfo.reset(new DMediaInfo(filePath));
-            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this));
+            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this, std::placeholders::_1));
         } else {
             if (callback)
                 callback(false, {});
@@ -142,8 +174,6 @@ void DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInf
 
 DFileFuture *DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, int ioPriority, QObject *parent)
 {
-    Q_UNUSED(ioPriority);
-
     if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration)
         || ids.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth)
         || ids.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight)) {
@@ -156,8 +186,18 @@ DFileFuture *DFileInfoPrivate::attributeExtend(DFileInfo::MediaType type, QList<
             extendIDs = ids;
             this->future = future;
 
+            QMap<DFileInfo::AttributeExtendID, QVariant> map;
+            if (cachedMediaValues(filePath, &map)) {
+                // the caller connects to the future after it is returned
+                const QUrl url = uri;
+                QMetaObject::invokeMethod(future, [future, url, map]() {
+                    Q_EMIT future->infoMedia(url, map);
+                }, Qt::QueuedConnection);
+                return future;
+            }
+
             this->mediaInfo.reset(new DMediaInfo(filePath));
-            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this));
+            this->mediaInfo->startReadInfo(std::bind(&DFileInfoPrivate::attributeExtendCallback, this, std::placeholders::_1), ioPriority);
 
             return future;
         } else {
@@ -183,26 +223,34 @@ bool DFileInfoPrivate::cancelAttributes()
     return cancelAttributeExtend();
 }
 
-void DFileInfoPrivate::attributeExtendCallback()
+static QMap<DFileInfo::AttributeExtendID, QVariant> mediaValuesMap(const QList<DFileInfo::AttributeExtendID> &ids,
+                                                                  const DMediaInfoCache::Values &values)
 {
-    if (this->mediaInfo) {
-        QMap<DFileInfo::AttributeExtendID, QVariant> map;
+    QMap<DFileInfo::AttributeExtendID, QVariant> map;
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaDuration, values.duration);
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaWidth, values.width);
+    if (ids.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight))
+        map.insert(DFileInfo::AttributeExtendID::kExtendMediaHeight, values.height);
+    return map;
+}
 
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaDuration)) {
-            QString duration = mediaInfo->value("Duration", mediaType);
-            if (duration.isEmpty()) {
-                duration = mediaInfo->value("Duration", DFileInfo::MediaType::kGeneral);
-            }
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaDuration, duration);
-        }
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaWidth)) {
-            const QString &width = mediaInfo->value("Width", mediaType);
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaWidth, width);
-        }
-        if (extendIDs.contains(DFileInfo::AttributeExtendID::kExtendMediaHeight)) {
-            const QString &height = mediaInfo->value("Height", mediaType);
-            map.insert(DFileInfo::AttributeExtendID::kExtendMediaHeight, height);
-        }
+void DFileInfoPrivate::attributeExtendCallback(bool opened)
+{
+    if (this->mediaInfo) {
+        // all three values are cached, another view may ask for the others
+        DMediaInfoCache::Values values;
+        values.duration = mediaInfo->value("Duration", mediaType);
+        if (values.duration.isEmpty())
+            values.duration = mediaInfo->value("Duration", DFileInfo::MediaType::kGeneral);
+        values.width = mediaInfo->value("Width", mediaType);
+        values.height = mediaInfo->value("Height", mediaType);
+        // a file that was not parsed, e.g. not readable yet, is tried again next time
+        if (opened && mediaStat.stx_mask)
+            DMediaInfoCache::instance()->insert(mediaStat, mediaType, values);
+
+        const QMap<DFileInfo::AttributeExtendID, QVariant> &map = mediaValuesMap(extendIDs, values);
 
         if (attributeExtendFuncCallback)
             attributeExtendFuncCallback(true, map);
@@ -212,6 +260,24 @@ void DFileInfoPrivate::attributeExtendCallback()
     }
 }
 
+bool DFileInfoPrivate::cachedMediaValues(const QString &filePath, QMap<DFileInfo::AttributeExtendID, QVariant> *map)
+{
+    // MediaInfo reads the target of a link, so links are followed whatever the query flag is
+    mediaStat = {};
+    const QByteArray &path = filePath.toLocal8Bit();
+    if (statx(AT_FDCWD, path.constData(), AT_NO_AUTOMOUNT, STATX_BASIC_STATS, &mediaStat) != 0) {
+        mediaStat = {};
+        return false;
+    }
+
+    DMediaInfoCache::Values values;
+    if (!DMediaInfoCache::instance()->lookup(mediaStat, mediaType, &values))
+        return false;
+
+    *map = mediaValuesMap(extendIDs, values);
+    return true;
+}
+
 void DFileInfoPrivate::setErrorFromGError(GError *gerror)
 {
     if (!gerror)
@@ -258,6 +324,7 @@ bool DFileInfoPrivate::queryInfoSync()
         this->gfileinfo = nullptr;
     }
     this->gfileinfo = fileinfo;
+    resetCaches();
     initFinished = true;
     isQuquerying = false;
     return true;
@@ -284,119 +351,224 @@ void DFileInfoPrivate::queryInfoAsync(int ioPriority, DFileInfo::InitQuerierAsyn
     g_file_query_info_async(this->gfile, attributes, GFileQueryInfoFlags(flag), ioPriority, gcancellable, queryInfoAsyncCallback, dataOp);
 }
 
-QVariant DFileInfoPrivate::attributesBySelf(DFileInfo::AttributeID id)
+void DFileInfoPrivate::loadLazyAttribute(DFileInfo::AttributeID id)
 {
-    QVariant retValue;
-    switch (id) {
-    case DFileInfo::AttributeID::kStandardIsHidden: {
-        retValue = DLocalHelper::fileIsHidden(q, {});
-        break;
-    }
-    case DFileInfo::AttributeID::kTimeCreated: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_btime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_btime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
+    if (id >= DFileInfo::AttributeID::kCustomStart)
+        return;
+
+    const char *key = DAttributeTable::key(id);
+    const char *pos = strstr(key, "::");
+    if (!pos)
+        return;
+
+    // 整个命名空间一起加载，同一命名空间的其他属性不必再查询
+    const QByteArray &nameSpace = QByteArray(key, static_cast<int>(pos - key)) + "::*";
+    GFileInfo *target = nullptr;
+    g_autoptr(GFile) file = nullptr;
+    {
+        QMutexLocker lk(&mutex);
+        if (!gfileinfo || !gfile || !attributes || g_file_info_has_attribute(gfileinfo, key))
+            return;
+
+        // an attribute the query asked for is missing because the file has none, asking again won't find it
+        if (!queriedMatcher)
+            queriedMatcher = g_file_attribute_matcher_new(attributes);
+        if (g_file_attribute_matcher_matches(queriedMatcher, key))
+            return;
+
+        if (lazyInfo != gfileinfo) {
+            lazyInfo = gfileinfo;
+            lazyNamespaces.clear();
         }
-        return qulonglong(ret);
+        if (lazyNamespaces.contains(nameSpace))
+            return;
+
+        target = gfileinfo;
+        file = G_FILE(g_object_ref(gfile));
     }
-    case DFileInfo::AttributeID::kTimeCreatedUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_btime.tv_nsec > 0
-                        ? statxBuffer.stx_btime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
-        }
-        return QVariant(ret);
+
+    // the query blocks, it runs without the lock. two threads may load the same namespace, the second adds nothing
+    g_autoptr(GFileInfo) info = g_file_query_info(file, nameSpace.constData(), GFileQueryInfoFlags(flag), nullptr, nullptr);
+
+    QMutexLocker lk(&mutex);
+    // refreshed meanwhile, the new info was queried with everything it needs
+    if (gfileinfo != target)
+        return;
+    lazyNamespaces.insert(nameSpace);
+    if (!info)
+        return;
+
+    g_auto(GStrv) keys = g_file_info_list_attributes(info, nullptr);
+    for (int i = 0; keys && keys[i]; ++i) {
+        GFileAttributeType type = G_FILE_ATTRIBUTE_TYPE_INVALID;
+        gpointer value = nullptr;
+        if (g_file_info_get_attribute_data(info, keys[i], &type, &value, nullptr))
+            g_file_info_set_attribute(gfileinfo, keys[i], type, value);
     }
-    case DFileInfo::AttributeID::kTimeModified: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_mtime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_mtime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
-        }
-        return qulonglong(ret);
+}
+
+bool DFileInfoPrivate::isStatAttribute(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardSize:
+    case DFileInfo::AttributeID::kStandardAllocatedSize:
+    case DFileInfo::AttributeID::kTimeModified:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+    case DFileInfo::AttributeID::kTimeAccess:
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+    case DFileInfo::AttributeID::kTimeChanged:
+    case DFileInfo::AttributeID::kTimeChangedUsec:
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kUnixDevice:
+    case DFileInfo::AttributeID::kUnixInode:
+    case DFileInfo::AttributeID::kUnixMode:
+    case DFileInfo::AttributeID::kUnixNlink:
+    case DFileInfo::AttributeID::kUnixUID:
+    case DFileInfo::AttributeID::kUnixGID:
+    case DFileInfo::AttributeID::kUnixRdev:
+    case DFileInfo::AttributeID::kUnixBlockSize:
+    case DFileInfo::AttributeID::kUnixBlocks:
+        return true;
+    default:
+        return false;
     }
-    case DFileInfo::AttributeID::kTimeModifiedUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
-        if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_mtime.tv_nsec > 0
-                        ? statxBuffer.stx_mtime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
+}
+
+bool DFileInfoPrivate::localStat(struct statx *st)
+{
+    QMutexLocker lk(&mutex);
+    if (!localStatDone) {
+        localStatDone = true;
+        localStatValid = false;
+        if (uri.isLocalFile()) {
+            const QByteArray &path = uri.toLocalFile().toLocal8Bit();
+            int flags = AT_NO_AUTOMOUNT;
+            if (flag == DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks)
+                flags |= AT_SYMLINK_NOFOLLOW;
+            localStatValid = statx(AT_FDCWD, path.constData(), flags, STATX_BASIC_STATS | STATX_BTIME, &localStatBuffer) == 0;
         }
-        return QVariant(ret);
     }
+    // copied under the lock, a refresh on another thread may stat again meanwhile
+    if (localStatValid)
+        *st = localStatBuffer;
+    return localStatValid;
+}
+
+void DFileInfoPrivate::resetLocalStat()
+{
+    QMutexLocker lk(&mutex);
+    localStatDone = false;
+    localStatValid = false;
+}
+
+void DFileInfoPrivate::setLocalStat(const struct statx &st)
+{
+    QMutexLocker lk(&mutex);
+    localStatBuffer = st;
+    localStatDone = true;
+    localStatValid = true;
+}
+
+QVariant DFileInfoPrivate::attributeFromStat(DFileInfo::AttributeID id)
+{
+    struct statx buffer;
+    if (!localStat(&buffer))
+        return QVariant();
+    const struct statx *st = &buffer;
+
+    // 时间为 0 时与 gio 的回退一致，使用 ctime
+    auto seconds = [st](const struct statx_timestamp &time) {
+        return quint64(time.tv_sec > 0 ? time.tv_sec : st->stx_ctime.tv_sec);
+    };
+    auto milliseconds = [st](const struct statx_timestamp &time) {
+        return uint32_t(time.tv_nsec > 0 ? time.tv_nsec / 1000000 : st->stx_ctime.tv_nsec / 1000000);
+    };
+
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardSize:
+        return qulonglong(st->stx_size);
+    case DFileInfo::AttributeID::kStandardAllocatedSize:
+        return qulonglong(st->stx_blocks * 512);
+    case DFileInfo::AttributeID::kTimeModified:
+        return qulonglong(seconds(st->stx_mtime));
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
+        return QVariant(milliseconds(st->stx_mtime));
+    case DFileInfo::AttributeID::kTimeAccess:
+        return qulonglong(seconds(st->stx_atime));
+    case DFileInfo::AttributeID::kTimeAccessUsec:
+        return QVariant(milliseconds(st->stx_atime));
+    case DFileInfo::AttributeID::kTimeChanged:
+        return qulonglong(st->stx_ctime.tv_sec);
+    case DFileInfo::AttributeID::kTimeChangedUsec:
+        return QVariant(uint32_t(st->stx_ctime.tv_nsec / 1000000));
+    case DFileInfo::AttributeID::kTimeCreated:
+        if (!(st->stx_mask & STATX_BTIME))
+            return qulonglong(st->stx_ctime.tv_sec);
+        return qulonglong(seconds(st->stx_btime));
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+        if (!(st->stx_mask & STATX_BTIME))
+            return QVariant(uint32_t(st->stx_ctime.tv_nsec / 1000000));
+        return QVariant(milliseconds(st->stx_btime));
+    case DFileInfo::AttributeID::kUnixDevice:
+        return QVariant(uint32_t(makedev(st->stx_dev_major, st->stx_dev_minor)));
+    case DFileInfo::AttributeID::kUnixInode:
+        return qulonglong(st->stx_ino);
+    case DFileInfo::AttributeID::kUnixMode:
+        return QVariant(uint32_t(st->stx_mode));
+    case DFileInfo::AttributeID::kUnixNlink:
+        return QVariant(uint32_t(st->stx_nlink));
+    case DFileInfo::AttributeID::kUnixUID:
+        return QVariant(uint32_t(st->stx_uid));
+    case DFileInfo::AttributeID::kUnixGID:
+        return QVariant(uint32_t(st->stx_gid));
+    case DFileInfo::AttributeID::kUnixRdev:
+        return QVariant(uint32_t(makedev(st->stx_rdev_major, st->stx_rdev_minor)));
+    case DFileInfo::AttributeID::kUnixBlockSize:
+        return QVariant(uint32_t(st->stx_blksize));
+    case DFileInfo::AttributeID::kUnixBlocks:
+        return qulonglong(st->stx_blocks);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant DFileInfoPrivate::attributesBySelf(DFileInfo::AttributeID id)
+{
+    switch (id) {
+    case DFileInfo::AttributeID::kStandardIsHidden:
+        return DLocalHelper::fileIsHidden(q, {});
+    case DFileInfo::AttributeID::kTimeCreated:
+    case DFileInfo::AttributeID::kTimeModified:
     case DFileInfo::AttributeID::kTimeAccess: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint64_t ret = g_file_info_get_attribute_uint64(gfileinfo, key.c_str());
+        const char *key = DAttributeTable::key(id);
+        uint64_t ret = 0;
+        {
+            // loadLazyAttribute() of another thread may add to gfileinfo
+            QMutexLocker lk(&mutex);
+            ret = g_file_info_get_attribute_uint64(gfileinfo, key);
+        }
         if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_atime.tv_sec > 0
-                        ? quint64(statxBuffer.stx_atime.tv_sec)
-                        : quint64(statxBuffer.stx_ctime.tv_sec);
-            }
+            // all time attributes share one statx per refresh
+            const QVariant &value = attributeFromStat(id);
+            if (value.isValid())
+                return value;
         }
         return qulonglong(ret);
     }
+    case DFileInfo::AttributeID::kTimeCreatedUsec:
+    case DFileInfo::AttributeID::kTimeModifiedUsec:
     case DFileInfo::AttributeID::kTimeAccessUsec: {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
-            return QVariant();
-        uint32_t ret = g_file_info_get_attribute_uint32(gfileinfo, key.c_str());
+        const char *key = DAttributeTable::key(id);
+        uint32_t ret = 0;
+        {
+            QMutexLocker lk(&mutex);
+            ret = g_file_info_get_attribute_uint32(gfileinfo, key);
+        }
         if (ret == 0) {
-            struct statx statxBuffer;
-            unsigned mask = STATX_BASIC_STATS | STATX_BTIME;
-            const QUrl &url = q->uri();
-            int ret = statx(AT_FDCWD, url.path().toStdString().data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &statxBuffer);
-            if (ret == 0) {
-                return statxBuffer.stx_atime.tv_nsec > 0
-                        ? statxBuffer.stx_atime.tv_nsec / 1000000
-                        : statxBuffer.stx_ctime.tv_nsec / 1000000;
-            }
+            const QVariant &value = attributeFromStat(id);
+            if (value.isValid())
+                return value;
         }
         return QVariant(ret);
     }
@@ -405,9 +577,8 @@ QVariant DFileInfoPrivate::attributesBySelf(DFileInfo::AttributeID id)
             return QUrl(g_file_get_uri(gfile));
         return uri;
     default:
-        return retValue;
+        return QVariant();
     }
-    return retValue;
 }
 
 QVariant DFileInfoPrivate::attributesFromUrl(DFileInfo::AttributeID id)
@@ -548,6 +719,7 @@ QFuture<void> DFileInfoPrivate::refreshAsync()
         }
         cacheAttributes();
         fileExists = exists();
+        existsCached = true;
         refreshing = false;
     });
     return futureRefresh;
@@ -555,19 +727,81 @@ QFuture<void> DFileInfoPrivate::refreshAsync()
 
 void DFileInfoPrivate::cacheAttributes()
 {
-    QMap<DFileInfo::AttributeID, QVariant> tmp;
-    for (const auto &[id, key] : DLocalHelper::attributeInfoMapFunc()) {
-        tmp.insert(id, q->attribute(id));
+    // values are cached lazily by attribute(), only the ones of the last query are dropped here
+    resetCaches();
+}
+
+int DFileInfoPrivate::attributeSlot(DFileInfo::AttributeID id)
+{
+    // permissions() is not an attribute of the table, it takes the slot after the last one
+    if (id == DFileInfo::AttributeID::kAccessPermissions)
+        return kAttributeCount;
+    return DAttributeTable::ordinal(id);
+}
+
+int DFileInfoPrivate::attributeSlotCount()
+{
+    return kAttributeCount + 1;
+}
+
+bool DFileInfoPrivate::cachedAttribute(DFileInfo::AttributeID id, QVariant *value) const
+{
+    std::shared_ptr<AttributeCache> cache;
+    const QVariant *cached = cachedValue(id, &cache);
+    if (!cached)
+        return false;
+    *value = *cached;
+    return true;
+}
+
+const QVariant *DFileInfoPrivate::cachedValue(DFileInfo::AttributeID id, std::shared_ptr<AttributeCache> *holder) const
+{
+    const int slot = attributeSlot(id);
+    if (slot < 0)
+        return nullptr;
+
+    *holder = std::atomic_load(&attributeCache);
+    if (!*holder || !(*holder)->has(slot))
+        return nullptr;
+    return &(*holder)->values[slot];
+}
+
+void DFileInfoPrivate::cacheAttribute(DFileInfo::AttributeID id, const QVariant &value, quint64 generation)
+{
+    const int slot = attributeSlot(id);
+    // queried again while the value was read, it may belong to the last query
+    if (slot < 0 || generation != cacheGeneration)
+        return;
+
+    std::shared_ptr<AttributeCache> cache = std::atomic_load(&attributeCache);
+    if (!cache) {
+        std::shared_ptr<AttributeCache> created = std::make_shared<AttributeCache>(attributeSlotCount());
+        // another thread may have created it meanwhile, then use that one
+        if (std::atomic_compare_exchange_strong(&attributeCache, &cache, created))
+            cache = created;
     }
 
-    tmp.insert(DFileInfo::AttributeID::kAccessPermissions, QVariant::fromValue(permissions()));
-    cacheing = true;
-    caches = tmp;
-    cacheing = false;
+    std::lock_guard<std::mutex> locker(cache->lock);
+    if (cache->has(slot))
+        return;
+    cache->values[slot] = value;
+    cache->present[static_cast<size_t>(slot) / 64].fetch_or(quint64(1) << (slot % 64), std::memory_order_release);
+}
+
+void DFileInfoPrivate::resetCaches()
+{
+    resetLocalStat();
+    existsCached = false;
+    ++cacheGeneration;
+    std::atomic_store(&attributeCache, std::shared_ptr<AttributeCache>());
 }
 
 DFile::Permissions DFileInfoPrivate::permissions() const
 {
+    QVariant cached;
+    if (cachedAttribute(DFileInfo::AttributeID::kAccessPermissions, &cached))
+        return cached.value<DFile::Permissions>();
+
     DFile::Permissions retValue = DFile::Permission::kNoPermission;
 
     if (!initFinished) {
@@ -576,6 +810,8 @@ DFile::Permissions DFileInfoPrivate::permissions() const
             return retValue;
     }
 
+    const quint64 generation = cacheGeneration;
+
     const QVariant &value = q->attribute(DFileInfo::AttributeID::kUnixMode);
     if (!value.isValid())
         return retValue;
@@ -608,6 +844,7 @@ DFile::Permissions DFileInfoPrivate::permissions() const
     if ((stMode & S_IROTH) == S_IROTH)
         retValue |= DFile::Permission::kReadOther;
 
+    const_cast<DFileInfoPrivate *>(this)->cacheAttribute(DFileInfo::AttributeID::kAccessPermissions, QVariant::fromValue(retValue), generation);
     return retValue;
 }
 
@@ -650,6 +887,7 @@ void DFileInfoPrivate::queryInfoAsyncCallback(GObject *sourceObject, GAsyncResul
 
     if (data->me) {
         data->me->gfileinfo = fileinfo;
+        data->me->resetCaches();
         data->me->initFinished = true;
     }
 
@@ -688,6 +926,7 @@ void DFileInfoPrivate::queryInfoAsyncCallback2(GObject *sourceObject, GAsyncResu
 
     if (data->me) {
         data->me->gfileinfo = fileinfo;
+        data->me->resetCaches();
         data->me->initFinished = true;
 
         future->finished();
@@ -753,6 +992,24 @@ bool DFileInfo::initQuerier()
 
 QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
 {
+    // not queried yet: stat attributes of local files come from one statx, g_file_query_info is not needed for them
+    if (!d->gfileinfo && DFileInfoPrivate::isStatAttribute(id)) {
+        const QVariant &value = const_cast<DFileInfoPrivate *>(d.data())->attributeFromStat(id);
+        if (value.isValid()) {
+            if (success)
+                *success = true;
+            return value;
+        }
+    }
+
+    QVariant retValue;
+    if (d->initFinished && d->cachedAttribute(id, &retValue)) {
+        if (success)
+            *success = true;
+        return retValue;
+    }
+    const quint64 generation = d->cacheGeneration;
+
     if (!d->initFinished) {
         bool succ = const_cast<DFileInfoPrivate *>(d.data())->queryInfoSync();
         if (!succ) {
@@ -769,19 +1026,21 @@ QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
         }
     }
 
-    QVariant retValue;
     if (id > DFileInfo::AttributeID::kCustomStart) {
         const QString &path = d->uri.path();
+        QMutexLocker lk(&d->mutex);
         retValue = DLocalHelper::customAttributeFromPathAndInfo(path, d->gfileinfo, id);
     } else {
         if (d->gfileinfo) {
             DFMIOErrorCode errorCode(DFM_IO_ERROR_NONE);
             if (!d->attributesRealizationSelf.contains(id)) {
+                const_cast<DFileInfoPrivate *>(d.data())->loadLazyAttribute(id);
                 QMutexLocker lk(&d->mutex);
                 retValue = DLocalHelper::attributeFromGFileInfo(d->gfileinfo, id, errorCode);
                 if (errorCode != DFM_IO_ERROR_NONE)
                     const_cast<DFileInfoPrivate *>(d.data())->error.setCode(errorCode);
             } else {
+                const_cast<DFileInfoPrivate *>(d.data())->loadLazyAttribute(id);
                 retValue = const_cast<DFileInfoPrivate *>(d.data())->attributesBySelf(id);
             }
         }
@@ -790,7 +1049,9 @@ QVariant DFileInfo::attribute(DFileInfo::AttributeID id, bool *success) const
         *success = retValue.isValid();
 
     if (!retValue.isValid())
-        retValue = std::get<1>(DLocalHelper::attributeInfoMapFunc().at(id));
+        retValue = DAttributeTable::defaultValue(id);
+    else if (d->gfileinfo)
+        const_cast<DFileInfoPrivate *>(d.data())->cacheAttribute(id, retValue, generation);
     return retValue;
 }
 
@@ -946,10 +1207,11 @@ bool DFileInfo::hasAttribute(DFileInfo::AttributeID id) const
     }
 
     if (d->gfileinfo) {
-        const std::string &key = DLocalHelper::attributeStringById(id);
-        if (key.empty())
+        const char *key = DAttributeTable::key(id);
+        if (!*key)
             return false;
-        return g_file_info_has_attribute(d->gfileinfo, key.c_str());
+        QMutexLocker lk(&d->mutex);
+        return g_file_info_has_attribute(d->gfileinfo, key);
     }
 
     return false;
@@ -957,7 +1219,7 @@ bool DFileInfo::hasAttribute(DFileInfo::AttributeID id) const
 
 bool DFileInfo::exists() const
 {
-    if (!d->cacheing && !d->caches.isEmpty())
+    if (d->existsCached)
         return d->fileExists;
 
     return d->exists();
@@ -965,6 +1227,7 @@ bool DFileInfo::exists() const
 
 bool DFileInfo::refresh()
 {
+    d->resetCaches();
     d->infoReseted = true;
     bool ret = d->queryInfoSync();
     d->infoReseted = false;
@@ -974,9 +1237,6 @@ bool DFileInfo::refresh()
 
 DFile::Permissions DFileInfo::permissions() const
 {
-    if (!d->cacheing && !d->caches.isEmpty())
-        return d->caches.value(AttributeID::kAccessPermissions).value<DFile::Permissions>();
-
     return d->permissions();
 }
 
@@ -1004,6 +1264,7 @@ QVariant DFileInfo::customAttribute(const char *key, const DFileInfo::DFileAttri
     if (!d->gfileinfo)
         return QVariant();
 
+    QMutexLocker lk(&d->mutex);
     switch (type) {
     case DFileInfo::DFileAttributeType::kTypeString: {
         const char *ret = g_file_info_get_attribute_string(d->gfileinfo, key);
@@ -1093,10 +1354,10 @@ DFileInfo::FileQueryInfoFlags DFileInfo::queryInfoFlag() const
 QString DFileInfo::dump() const
 {
     QString ret;
-    for (const auto &[id, key] : DLocalHelper::attributeInfoMapFunc()) {
-        const QVariant &&value = attribute(id);
+    for (const auto &desc : kAttributeDescriptors) {
+        const QVariant &&value = attribute(desc.id);
         if (value.isValid()) {
-            ret.append(std::get<0>(DLocalHelper::attributeInfoMapFunc().at(id)).c_str());
+            ret.append(desc.key);
             ret.append(":");
             ret.append(value.toString());
             ret.append("\n");
@@ -1109,3 +1370,69 @@ bool DFileInfo::queryAttributeFinished() const
 {
     return d->initFinished;
 }
+
+qint64 DFileInfo::size() const
+{
+    return static_cast<qint64>(get<AttributeID::kStandardSize>());
+}
+
+quint32 DFileInfo::mode() const
+{
+    return get<AttributeID::kUnixMode>();
+}
+
+quint64 DFileInfo::inode() const
+{
+    return get<AttributeID::kUnixInode>();
+}
+
+QString DFileInfo::name() const
+{
+    return get<AttributeID::kStandardName>();
+}
+
+QString DFileInfo::displayName() const
+{
+    return get<AttributeID::kStandardDisplayName>();
+}
+
+quint64 DFileInfo::unsignedValue(DFileInfo::AttributeID id) const
+{
+    std::shared_ptr<DFileInfoPrivate::AttributeCache> cache;
+    if (d->initFinished) {
+        if (const QVariant *value = d->cachedValue(id, &cache))
+            return value->toULongLong();
+    }
+    return attribute(id).toULongLong();
+}
+
+qint64 DFileInfo::signedValue(DFileInfo::AttributeID id) const
+{
+    std::shared_ptr<DFileInfoPrivate::AttributeCache> cache;
+    if (d->initFinished) {
+        if (const QVariant *value = d->cachedValue(id, &cache))
+            return value->toLongLong();
+    }
+    return attribute(id).toLongLong();
+}
+
+bool DFileInfo::boolValue(DFileInfo::AttributeID id) const
+{
+    std::shared_ptr<DFileInfoPrivate::AttributeCache> cache;
+    if (d->initFinished) {
+        if (const QVariant *value = d->cachedValue(id, &cache))
+            return value->toBool();
+    }
+    return attribute(id).toBool();
+}
+
+QString DFileInfo::stringValue(DFileInfo::AttributeID id) const
+{
+    // the copy holds a reference of the cached string, a refresh on another thread can not free it
+    std::shared_ptr<DFileInfoPrivate::AttributeCache> cache;
+    if (d->initFinished) {
+        if (const QVariant *value = d->cachedValue(id, &cache))
+            return value->toString();
+    }
+    return attribute(id).toString();
+}
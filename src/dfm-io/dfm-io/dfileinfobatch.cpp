@@ -0,0 +1,467 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/dfileinfobatch_p.h"
+#include "private/dfileinfo_p.h"
+
+#include "utils/dlocaldirreader.h"
+#include "utils/dattributetable.h"
+
+#include <QHash>
+#include <QThread>
+
+#include <gio/gio.h>
+#include <gio-unix-2.0/gio/gunixmounts.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+USING_IO_NAMESPACE
+
+static constexpr int kGroupSize { 256 };   // urls of one directory handled by one worker at a time
+static constexpr unsigned int kStatMask { STATX_BASIC_STATS | STATX_BTIME };   // the mask of DFileInfoPrivate::localStat()
+
+static bool isRemoteFsType(const char *fsType)
+{
+    static const char *const kRemoteTypes[] { "nfs", "nfs4", "cifs", "smb3", "smbfs", "ncpfs", "afs", "9p",
+                                              "ceph", "glusterfs", "davfs", "sshfs" };
+    if (!fsType)
+        return false;
+    if (strncmp(fsType, "fuse.", 5) == 0)
+        return true;
+    return std::any_of(std::begin(kRemoteTypes), std::end(kRemoteTypes), [fsType](const char *type) {
+        return strcmp(type, fsType) == 0;
+    });
+}
+
+/************************************************
+ * DFileInfoBatchPrivate
+ ***********************************************/
+
+DFileInfoBatchPrivate::DFileInfoBatchPrivate(DFileInfoBatch *q)
+    : q(q),
+      threadCount(qBound(4, QThread::idealThreadCount(), 16))
+{
+}
+
+DFileInfoBatchPrivate::~DFileInfoBatchPrivate()
+{
+    // no finished() from the workers of an object being destroyed
+    running = false;
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        canceled = true;
+    }
+    stop();
+}
+
+void DFileInfoBatchPrivate::buildGroups()
+{
+    // mount points of the local files, the longest matching one wins
+    struct MountPoint
+    {
+        QString path;
+        bool remote { false };
+    };
+    QList<MountPoint> mountPoints;
+    GList *entries = g_unix_mounts_get(nullptr);
+    for (GList *it = entries; it; it = it->next) {
+        GUnixMountEntry *entry = static_cast<GUnixMountEntry *>(it->data);
+        mountPoints.append({ QString::fromLocal8Bit(g_unix_mount_get_mount_path(entry)),
+                             isRemoteFsType(g_unix_mount_get_fs_type(entry)) });
+    }
+    g_list_free_full(entries, reinterpret_cast<GDestroyNotify>(g_unix_mount_free));
+    std::sort(mountPoints.begin(), mountPoints.end(), [](const MountPoint &left, const MountPoint &right) {
+        return left.path.length() > right.path.length();
+    });
+
+    QHash<QString, size_t> mountIndexes;
+    auto mountOf = [&](const QString &key, bool remote) {
+        auto it = mountIndexes.find(key);
+        if (it != mountIndexes.end())
+            return it.value();
+        Mount mount;
+        mount.limit = remote ? remoteMountConcurrency : mountConcurrency;
+        mounts.push_back(std::move(mount));
+        return mountIndexes.insert(key, mounts.size() - 1).value();
+    };
+
+    QHash<QString, Group> groups;
+    QHash<QString, size_t> groupMounts;
+    auto flush = [this](Group *group, size_t mountIndex) {
+        mounts[mountIndex].pending.push_back(std::move(*group));
+        *group = Group();
+    };
+
+    for (const QUrl &url : urls) {
+        QString groupKey;
+        size_t mountIndex = 0;
+        bool local = url.isLocalFile();
+        QString path;
+        if (local) {
+            path = url.toLocalFile();
+            while (path.length() > 1 && path.endsWith('/'))
+                path.chop(1);
+            const int pos = path.lastIndexOf('/');
+            groupKey = pos > 0 ? path.left(pos) : QString("/");
+            const auto it = std::find_if(mountPoints.cbegin(), mountPoints.cend(), [&groupKey](const MountPoint &point) {
+                return point.path == "/" || groupKey == point.path || groupKey.startsWith(point.path + '/');
+            });
+            mountIndex = it == mountPoints.cend() ? mountOf(QString("/"), false) : mountOf(it->path, it->remote);
+        } else {
+            groupKey = url.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash).toString();
+            mountIndex = mountOf(url.scheme() + "://" + url.authority(), true);
+        }
+
+        Group &group = groups[groupKey];
+        if (group.urls.isEmpty()) {
+            group.local = local;
+            group.dirPath = groupKey.toLocal8Bit().toStdString();
+            groupMounts.insert(groupKey, mountIndex);
+        }
+        group.urls.append(url);
+        if (local) {
+            const int pos = path.lastIndexOf('/');
+            // the root itself has no name in a parent, it is checked by path
+            group.names.push_back(path == "/" ? std::string() : path.mid(pos + 1).toLocal8Bit().toStdString());
+        }
+        if (group.urls.size() >= kGroupSize)
+            flush(&group, mountIndex);
+    }
+
+    for (auto it = groups.begin(); it != groups.end(); ++it) {
+        if (!it.value().urls.isEmpty())
+            flush(&it.value(), groupMounts.value(it.key()));
+    }
+}
+
+void DFileInfoBatchPrivate::workerLoop()
+{
+    Group group;
+    size_t mountIndex = 0;
+    while (takeGroup(&group, &mountIndex)) {
+        if (group.local)
+            processLocal(group);
+        else
+            processRemote(group);
+        finishGroup(mountIndex, group.urls.size());
+    }
+
+    // after a cancel pendingUrls never drops to 0, the last worker out ends the run instead of finishGroup()
+    bool last = false;
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        last = --liveWorkers == 0;
+    }
+    if (last && canceled && running.exchange(false))
+        Q_EMIT q->finished();
+}
+
+bool DFileInfoBatchPrivate::takeGroup(Group *group, size_t *mountIndex)
+{
+    std::unique_lock<std::mutex> locker(lock);
+    while (true) {
+        if (canceled || pendingUrls == 0)
+            return false;
+
+        for (size_t i = 0; i < mounts.size(); ++i) {
+            const size_t index = (nextMount + i) % mounts.size();
+            Mount &mount = mounts[index];
+            if (mount.pending.empty() || mount.running >= mount.limit)
+                continue;
+            *group = std::move(mount.pending.front());
+            mount.pending.pop_front();
+            ++mount.running;
+            *mountIndex = index;
+            nextMount = index + 1;
+            return true;
+        }
+
+        // every mount with work left is at its limit
+        workCondition.wait(locker);
+    }
+}
+
+void DFileInfoBatchPrivate::finishGroup(size_t mountIndex, int count)
+{
+    bool allDone = false;
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        --mounts[mountIndex].running;
+        pendingUrls -= count;
+        allDone = pendingUrls == 0;
+    }
+    finishedCount += count;
+    workCondition.notify_all();
+    if (!allDone)
+        return;
+
+    if (!canceled) {
+        running = false;
+        Q_EMIT q->finished();
+    }
+    doneCondition.notify_all();
+}
+
+void DFileInfoBatchPrivate::processLocal(const Group &group)
+{
+    // O_PATH: nothing is read from the directory, it only anchors the statx calls
+    const int dirFd = ::open(group.dirPath.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    const bool follow = flag != DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks;
+
+    QList<QSharedPointer<DFileInfo>> infos;
+    QList<QUrl> failed;
+    for (int i = 0; i < group.urls.size() && !canceled; ++i) {
+        const QUrl &url = group.urls.at(i);
+        const std::string &name = group.names[static_cast<size_t>(i)];
+
+        const int atFd = dirFd >= 0 && !name.empty() ? dirFd : AT_FDCWD;
+        const QByteArray &path = atFd == AT_FDCWD ? url.toLocalFile().toLocal8Bit() : QByteArray();
+        const char *atName = atFd == AT_FDCWD ? path.constData() : name.c_str();
+
+        struct statx st;
+        bool exists = DLocalDirReader::statAt(atFd, atName, kStatMask, follow, &st);
+        // statOfFlag: st is what the info's own localStat() gives for this flag
+        const bool statOfFlag = exists;
+        if (!exists && follow && errno == ENOENT) {
+            // a dangling symlink still exists, g_file_query_info() gives the info of the link itself
+            struct statx linkSt;
+            exists = DLocalDirReader::statAt(atFd, atName, kStatMask, false, &linkSt);
+        }
+        if (!exists) {
+            failed.append(url);
+            continue;
+        }
+
+        QSharedPointer<DFileInfo> info(new DFileInfo(url, attributes.constData(), flag));
+        if (queryNeeded && !info->initQuerier()) {
+            failed.append(url);
+            continue;
+        }
+        // after the query, it would drop the stat
+        if (statOfFlag)
+            info->d->setLocalStat(st);
+        infos.append(info);
+    }
+
+    if (dirFd >= 0)
+        ::close(dirFd);
+
+    report(infos, failed);
+}
+
+void DFileInfoBatchPrivate::processRemote(const Group &group)
+{
+    QList<QSharedPointer<DFileInfo>> infos;
+    QList<QUrl> failed;
+    for (const QUrl &url : group.urls) {
+        if (canceled)
+            return;
+
+        QSharedPointer<DFileInfo> info(new DFileInfo(url, attributes.constData(), flag));
+        if (info->initQuerier())
+            infos.append(info);
+        else
+            failed.append(url);
+    }
+
+    report(infos, failed);
+}
+
+void DFileInfoBatchPrivate::report(const QList<QSharedPointer<DFileInfo>> &infos, const QList<QUrl> &failed)
+{
+    if (canceled)
+        return;
+    if (!infos.isEmpty()) {
+        // the infos were made in this worker, which is gone soon. they belong to the thread of the batch
+        for (const auto &info : infos)
+            info->d->moveToThread(q->thread());
+        Q_EMIT q->infosReady(infos);
+    }
+    if (!failed.isEmpty())
+        Q_EMIT q->infosFailed(failed);
+}
+
+QByteArray DFileInfoBatchPrivate::attributeString() const
+{
+    if (attributeIds.isEmpty())
+        return QByteArray("*");
+
+    QList<QByteArray> keys;
+    for (const auto id : attributeIds) {
+        // 自定义属性由 standard::name 和 standard::type 计算得到
+        if (id >= DFileInfo::AttributeID::kCustomStart)
+            continue;
+        const char *key = DAttributeTable::key(id);
+        if (*key)
+            keys.append(QByteArray(key));
+    }
+    keys.append(G_FILE_ATTRIBUTE_STANDARD_NAME);
+    keys.append(G_FILE_ATTRIBUTE_STANDARD_TYPE);
+    return keys.join(',');
+}
+
+bool DFileInfoBatchPrivate::needsQuery() const
+{
+    if (attributeIds.isEmpty())
+        return true;
+    return !std::all_of(attributeIds.cbegin(), attributeIds.cend(), [](DFileInfo::AttributeID id) {
+        return DFileInfoPrivate::isStatAttribute(id);
+    });
+}
+
+void DFileInfoBatchPrivate::stop()
+{
+    workCondition.notify_all();
+    for (auto &worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+    running = false;
+}
+
+/************************************************
+ * DFileInfoBatch
+ ***********************************************/
+
+DFileInfoBatch::DFileInfoBatch(const QList<QUrl> &urls, QObject *parent)
+    : QObject(parent), d(new DFileInfoBatchPrivate(this))
+{
+    qRegisterMetaType<QList<QSharedPointer<DFMIO::DFileInfo>>>();
+    d->urls = urls;
+}
+
+DFileInfoBatch::~DFileInfoBatch()
+{
+}
+
+QList<QUrl> DFileInfoBatch::urls() const
+{
+    return d->urls;
+}
+
+void DFileInfoBatch::setQueryAttributes(const QList<DFileInfo::AttributeID> &ids)
+{
+    d->attributeIds = ids;
+}
+
+QList<DFileInfo::AttributeID> DFileInfoBatch::queryAttributes() const
+{
+    return d->attributeIds;
+}
+
+void DFileInfoBatch::setQueryInfoFlag(DFileInfo::FileQueryInfoFlags flag)
+{
+    d->flag = flag;
+}
+
+DFileInfo::FileQueryInfoFlags DFileInfoBatch::queryInfoFlag() const
+{
+    return d->flag;
+}
+
+void DFileInfoBatch::setThreadCount(int count)
+{
+    d->threadCount = qMax(1, count);
+}
+
+int DFileInfoBatch::threadCount() const
+{
+    return d->threadCount;
+}
+
+void DFileInfoBatch::setMountConcurrency(int count)
+{
+    d->mountConcurrency = qMax(1, count);
+}
+
+int DFileInfoBatch::mountConcurrency() const
+{
+    return d->mountConcurrency;
+}
+
+void DFileInfoBatch::setRemoteMountConcurrency(int count)
+{
+    d->remoteMountConcurrency = qMax(1, count);
+}
+
+int DFileInfoBatch::remoteMountConcurrency() const
+{
+    return d->remoteMountConcurrency;
+}
+
+bool DFileInfoBatch::start()
+{
+    if (d->running)
+        return true;
+
+    d->stop();
+    d->canceled = false;
+    d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_NONE);
+    d->mounts.clear();
+    d->nextMount = 0;
+    d->finishedCount = 0;
+    d->attributes = d->attributeString();
+    d->queryNeeded = d->needsQuery();
+
+    if (d->urls.isEmpty()) {
+        Q_EMIT finished();
+        return true;
+    }
+
+    d->buildGroups();
+    d->pendingUrls = d->urls.size();
+    d->liveWorkers = d->threadCount;
+    d->running = true;
+    for (int i = 0; i < d->threadCount; ++i)
+        d->workers.emplace_back(&DFileInfoBatchPrivate::workerLoop, d.data());
+
+    return true;
+}
+
+void DFileInfoBatch::cancel()
+{
+    if (!d->running)
+        return;
+
+    {
+        std::lock_guard<std::mutex> locker(d->lock);
+        d->canceled = true;
+    }
+    d->error.setCode(DFMIOErrorCode::DFM_IO_ERROR_CANCELLED);
+    d->workCondition.notify_all();
+    d->doneCondition.notify_all();
+}
+
+bool DFileInfoBatch::waitForFinished()
+{
+    {
+        std::unique_lock<std::mutex> locker(d->lock);
+        d->doneCondition.wait(locker, [this]() {
+            return d->canceled || d->pendingUrls == 0;
+        });
+    }
+    d->stop();
+    return !d->canceled;
+}
+
+bool DFileInfoBatch::isRunning() const
+{
+    return d->running;
+}
+
+int DFileInfoBatch::finishedCount() const
+{
+    return d->finishedCount;
+}
+
+DFMIOError DFileInfoBatch::lastError() const
+{
+    return d->error;
+}
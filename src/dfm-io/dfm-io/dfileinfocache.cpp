@@ -0,0 +1,257 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/dfileinfocache_p.h"
+
+#include <QDebug>
+
+USING_IO_NAMESPACE
+
+/************************************************
+ * DFileInfoCachePrivate
+ ***********************************************/
+
+DFileInfoCachePrivate::DFileInfoCachePrivate(DFileInfoCache *q)
+    : q(q)
+{
+    timer.start();
+}
+
+QUrl DFileInfoCachePrivate::keyOf(const QUrl &url)
+{
+    return url.adjusted(QUrl::StripTrailingSlash | QUrl::NormalizePathSegments);
+}
+
+QUrl DFileInfoCachePrivate::parentOf(const QUrl &key)
+{
+    return key.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash);
+}
+
+QSharedPointer<const DFileInfo> DFileInfoCachePrivate::find(const QUrl &key)
+{
+    auto it = index.find(key);
+    if (it == index.end())
+        return nullptr;
+
+    EntryList::iterator entry = it.value();
+    if (entry->expires > 0 && entry->expires <= timer.elapsed()) {
+        drop(entry);
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, entry);
+    return entry->info;
+}
+
+void DFileInfoCachePrivate::add(const QUrl &key, const QSharedPointer<const DFileInfo> &info)
+{
+    auto it = index.find(key);
+    if (it != index.end())
+        drop(it.value());
+
+    Entry entry;
+    entry.url = key;
+    entry.info = info;
+    if (!key.isLocalFile() && remoteTimeToLive > 0)
+        entry.expires = timer.elapsed() + remoteTimeToLive;
+    entries.push_front(std::move(entry));
+    index.insert(key, entries.begin());
+    countBelow(key, 1);
+
+    while (static_cast<int>(entries.size()) > maxCount)
+        drop(std::prev(entries.end()));
+}
+
+void DFileInfoCachePrivate::drop(EntryList::iterator it)
+{
+    countBelow(it->url, -1);
+    index.remove(it->url);
+    entries.erase(it);
+}
+
+void DFileInfoCachePrivate::countBelow(const QUrl &key, int delta)
+{
+    // every ancestor, up to the root whose parent is itself
+    for (QUrl dir = parentOf(key), child = key; dir != child; child = dir, dir = parentOf(dir)) {
+        auto count = descendantCounts.find(dir);
+        if (count == descendantCounts.end())
+            count = descendantCounts.insert(dir, 0);
+        count.value() += delta;
+        if (count.value() <= 0)
+            descendantCounts.erase(count);
+    }
+}
+
+void DFileInfoCachePrivate::invalidate(const QUrl &url, bool withChildren)
+{
+    const QUrl &key = keyOf(url);
+    auto it = index.find(key);
+    if (it != index.end())
+        drop(it.value());
+
+    // an entry was added, removed or renamed in the parent, its times changed
+    it = index.find(parentOf(key));
+    if (it != index.end())
+        drop(it.value());
+
+    if (!withChildren || !descendantCounts.contains(key))
+        return;
+
+    for (auto entry = entries.begin(); entries.end() != entry;) {
+        if (key.isParentOf(entry->url))
+            drop(entry++);
+        else
+            ++entry;
+    }
+}
+
+/************************************************
+ * DFileInfoCache
+ ***********************************************/
+
+DFileInfoCache *DFileInfoCache::instance()
+{
+    static DFileInfoCache cache;
+    return &cache;
+}
+
+DFileInfoCache::DFileInfoCache(QObject *parent)
+    : QObject(parent), d(new DFileInfoCachePrivate(this))
+{
+}
+
+DFileInfoCache::~DFileInfoCache()
+{
+}
+
+QSharedPointer<const DFileInfo> DFileInfoCache::info(const QUrl &url)
+{
+    QSharedPointer<const DFileInfo> cached = cachedInfo(url);
+    if (cached)
+        return cached;
+
+    // queried without the lock, two callers missing at once both query, the later one wins
+    QSharedPointer<DFileInfo> info(new DFileInfo(url));
+    if (!info->initQuerier())
+        return nullptr;
+    insert(info);
+    return info;
+}
+
+QSharedPointer<const DFileInfo> DFileInfoCache::cachedInfo(const QUrl &url)
+{
+    QMutexLocker lk(&d->lock);
+    return d->find(DFileInfoCachePrivate::keyOf(url));
+}
+
+void DFileInfoCache::insert(const QSharedPointer<DFileInfo> &info)
+{
+    if (!info)
+        return;
+    // queried here, readers of the shared info must never start the query of it
+    if (!info->initQuerier())
+        return;
+
+    QMutexLocker lk(&d->lock);
+    d->add(DFileInfoCachePrivate::keyOf(info->uri()), info);
+}
+
+void DFileInfoCache::remove(const QUrl &url)
+{
+    QMutexLocker lk(&d->lock);
+    auto it = d->index.find(DFileInfoCachePrivate::keyOf(url));
+    if (it != d->index.end())
+        d->drop(it.value());
+}
+
+void DFileInfoCache::clear()
+{
+    QMutexLocker lk(&d->lock);
+    d->entries.clear();
+    d->index.clear();
+    d->descendantCounts.clear();
+}
+
+int DFileInfoCache::count() const
+{
+    QMutexLocker lk(&d->lock);
+    return static_cast<int>(d->entries.size());
+}
+
+void DFileInfoCache::setMaxCount(int count)
+{
+    QMutexLocker lk(&d->lock);
+    d->maxCount = qMax(1, count);
+    while (static_cast<int>(d->entries.size()) > d->maxCount)
+        d->drop(std::prev(d->entries.end()));
+}
+
+int DFileInfoCache::maxCount() const
+{
+    QMutexLocker lk(&d->lock);
+    return d->maxCount;
+}
+
+void DFileInfoCache::setRemoteTimeToLive(int msec)
+{
+    QMutexLocker lk(&d->lock);
+    d->remoteTimeToLive = qMax(0, msec);
+}
+
+int DFileInfoCache::remoteTimeToLive() const
+{
+    QMutexLocker lk(&d->lock);
+    return d->remoteTimeToLive;
+}
+
+void DFileInfoCache::attachWatcher(DWatcher *watcher)
+{
+    if (!watcher)
+        return;
+
+    // direct connections, the entries must be gone before the receivers of the watcher query again
+    connect(watcher, &DWatcher::fileChanged, this, [this](const QUrl &url) {
+        QMutexLocker lk(&d->lock);
+        d->invalidate(url, false);
+    }, Qt::DirectConnection);
+    connect(watcher, &DWatcher::fileAdded, this, [this](const QUrl &url) {
+        QMutexLocker lk(&d->lock);
+        d->invalidate(url, false);
+    }, Qt::DirectConnection);
+    connect(watcher, &DWatcher::fileDeleted, this, [this](const QUrl &url) {
+        QMutexLocker lk(&d->lock);
+        d->invalidate(url, true);
+    }, Qt::DirectConnection);
+    connect(watcher, &DWatcher::fileRenamed, this, [this](const QUrl &fromUrl, const QUrl &toUrl) {
+        QMutexLocker lk(&d->lock);
+        d->invalidate(fromUrl, true);
+        d->invalidate(toUrl, true);
+    }, Qt::DirectConnection);
+}
+
+bool DFileInfoCache::watch(const QUrl &dirUrl)
+{
+    const QUrl &key = DFileInfoCachePrivate::keyOf(dirUrl);
+    if (d->watchers.contains(key))
+        return true;
+
+    DWatcher *watcher = new DWatcher(key, this);
+    watcher->setWatchType(DWatcher::WatchType::kDir);
+    if (!watcher->start()) {
+        qWarning() << "file info cache can not watch" << key << watcher->lastError().errorMsg();
+        delete watcher;
+        return false;
+    }
+    attachWatcher(watcher);
+    d->watchers.insert(key, watcher);
+    return true;
+}
+
+void DFileInfoCache::unwatch(const QUrl &dirUrl)
+{
+    DWatcher *watcher = d->watchers.take(DFileInfoCachePrivate::keyOf(dirUrl));
+    if (!watcher)
+        return;
+    watcher->stop();
+    watcher->deleteLater();
+}
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/dfilemapping_p.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+
+USING_IO_NAMESPACE
+
+static int adviceFlag(DFileMapping::Advice advice)
+{
+    switch (advice) {
+    case DFileMapping::Advice::kSequential:
+        return MADV_SEQUENTIAL;
+    case DFileMapping::Advice::kRandom:
+        return MADV_RANDOM;
+    case DFileMapping::Advice::kWillNeed:
+        return MADV_WILLNEED;
+    case DFileMapping::Advice::kDontNeed:
+        return MADV_DONTNEED;
+    default:
+        return MADV_NORMAL;
+    }
+}
+
+/************************************************
+ * DFileMappingPrivate
+ ***********************************************/
+
+DFileMappingPrivate::~DFileMappingPrivate()
+{
+    if (mapped)
+        munmap(mapped, mappedSize);
+}
+
+int DFileMappingPrivate::map(int fd, qint64 offset, qint64 size)
+{
+    this->offset = offset;
+    this->size = size;
+    if (size == 0) {
+        data = "";
+        valid = true;
+        return 0;
+    }
+
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 start = offset - offset % pageSize;
+    mappedSize = static_cast<size_t>(size + offset - start);
+    void *addr = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(start));
+    if (addr == MAP_FAILED) {
+        mappedSize = 0;
+        return errno;
+    }
+
+    mapped = addr;
+    data = static_cast<const char *>(addr) + (offset - start);
+    valid = true;
+    return 0;
+}
+
+/************************************************
+ * DFileMapping
+ ***********************************************/
+
+DFileMapping::DFileMapping()
+    : d(new DFileMappingPrivate)
+{
+}
+
+DFileMapping::DFileMapping(const DFileMapping &other) = default;
+
+DFileMapping &DFileMapping::operator=(const DFileMapping &other) = default;
+
+DFileMapping::~DFileMapping() = default;
+
+bool DFileMapping::isValid() const
+{
+    return d->valid;
+}
+
+const char *DFileMapping::data() const
+{
+    return d->data;
+}
+
+qint64 DFileMapping::size() const
+{
+    return d->size;
+}
+
+qint64 DFileMapping::offset() const
+{
+    return d->offset;
+}
+
+QByteArray DFileMapping::toByteArray() const
+{
+    if (!d->valid)
+        return QByteArray();
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return QByteArray::fromRawData(d->data, d->size);
+#else
+    // a QByteArray of Qt 5 holds at most INT_MAX bytes, use data() for larger mappings
+    return QByteArray::fromRawData(d->data, static_cast<int>(qMin<qint64>(d->size, INT_MAX)));
+#endif
+}
+
+bool DFileMapping::advise(Advice advice) const
+{
+    return advise(advice, 0, d->size);
+}
+
+bool DFileMapping::advise(Advice advice, qint64 offset, qint64 length) const
+{
+    if (!d->valid || offset < 0 || length < 0 || offset + length > d->size)
+        return false;
+    if (length == 0)
+        return true;
+
+    // madvise needs a page aligned start, widen the range to the page of offset
+    const char *base = static_cast<const char *>(d->mapped);
+    const char *begin = d->data + offset;
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 aligned = (begin - base) - (begin - base) % pageSize;
+    const size_t len = static_cast<size_t>(begin - base - aligned + length);
+    return madvise(const_cast<char *>(base) + aligned, len, adviceFlag(advice)) == 0;
+}
@@ -0,0 +1,418 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/dfiletable_p.h"
+
+#include "utils/dsortkeybuilder.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+/************************************************
+ * DFileTablePrivate
+ ***********************************************/
+
+int DFileTablePrivate::append(const FTSENT *ent, const QSet<QString> &hideList)
+{
+    const int index = count();
+    nameOffsets.push_back(static_cast<quint32>(names.size()));
+    names.append(ent->fts_name, ent->fts_namelen);
+    names.push_back('\0');
+
+    const struct stat *st = ent->fts_statp;
+    uint8_t flag = 0;
+    bool isDir = false;
+    if (S_ISLNK(st->st_mode)) {
+        flag |= kIsSymLink;
+        char buffer[4096] { 0 };
+        const ssize_t size = readlink(ent->fts_path, buffer, sizeof(buffer));
+        if (size > 0)
+            symlinkTargets.insert(index, QByteArray(buffer, static_cast<int>(size)));
+        struct stat targetSt;
+        if (stat(ent->fts_path, &targetSt) == 0)
+            isDir = S_ISDIR(targetSt.st_mode);
+    } else {
+        isDir = S_ISDIR(st->st_mode);
+    }
+
+    if (isDir)
+        flag |= kIsDir;
+    if (ent->fts_name[0] == '.' || (!hideList.isEmpty() && hideList.contains(QString::fromUtf8(ent->fts_name, ent->fts_namelen))))
+        flag |= kIsHide;
+    if (st->st_mode & S_IREAD)
+        flag |= kIsReadable;
+    if (st->st_mode & S_IWRITE)
+        flag |= kIsWriteable;
+    if (st->st_mode & S_IEXEC)
+        flag |= kIsExecutable;
+    flags.push_back(flag);
+
+    sizes.push_back(st->st_size);
+    modes.push_back(st->st_mode);
+    inodes.push_back(st->st_ino);
+    uids.push_back(st->st_uid);
+    gids.push_back(st->st_gid);
+    lastReadSecs.push_back(st->st_atim.tv_sec);
+    lastReadNsecs.push_back(static_cast<quint32>(st->st_atim.tv_nsec));
+    lastModifiedSecs.push_back(st->st_mtim.tv_sec);
+    lastModifiedNsecs.push_back(static_cast<quint32>(st->st_mtim.tv_nsec));
+    createdSecs.push_back(st->st_ctim.tv_sec);
+    createdNsecs.push_back(static_cast<quint32>(st->st_ctim.tv_nsec));
+
+    order.push_back(index);
+    return index;
+}
+
+int DFileTablePrivate::nameLength(int index) const
+{
+    const size_t next = static_cast<size_t>(index) + 1;
+    const size_t end = next < nameOffsets.size() ? nameOffsets[next] : names.size();
+    return static_cast<int>(end - nameOffsets[static_cast<size_t>(index)] - 1);
+}
+
+QString DFileTablePrivate::fileName(int index) const
+{
+    return QString::fromUtf8(name(index), nameLength(index));
+}
+
+QByteArray DFileTablePrivate::filePath(int index) const
+{
+    QByteArray path = dirPath;
+    if (!path.endsWith('/'))
+        path.append('/');
+    path.append(name(index), nameLength(index));
+    return path;
+}
+
+void DFileTablePrivate::prepareSort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile)
+{
+    sortRole = role;
+    sortOrder = order;
+    sortMixDirAndFile = mixDirAndFile;
+    sortedCount = 0;
+    this->order.resize(static_cast<size_t>(count()));
+    std::iota(this->order.begin(), this->order.end(), 0);
+
+    sortKeys.clear();
+    sortKeyOffsets.clear();
+    if (role == DEnumerator::SortRoleCompareFlag::kSortRoleCompareDefault)
+        return;
+
+    // name keys are the tie-break of every role, built once per row
+    QStringList fileNames;
+    fileNames.reserve(count());
+    DSortKeyBuilder builder;
+    for (int i = 0; i < count(); ++i) {
+        fileNames.append(fileName(i));
+        builder.addName(fileNames.last());
+    }
+    builder.prepare();
+
+    sortKeyOffsets.reserve(static_cast<size_t>(count()) + 1);
+    for (const QString &name : fileNames) {
+        sortKeyOffsets.push_back(static_cast<quint32>(sortKeys.size()));
+        const QByteArray &key = builder.key(name);
+        sortKeys.append(key.constData(), static_cast<size_t>(key.size()));
+    }
+    sortKeyOffsets.push_back(static_cast<quint32>(sortKeys.size()));
+}
+
+int DFileTablePrivate::compareRows(int left, int right) const
+{
+    const size_t l = static_cast<size_t>(left);
+    const size_t r = static_cast<size_t>(right);
+    auto compare = [](auto a, auto b) { return a == b ? 0 : (a < b ? -1 : 1); };
+
+    int ret = 0;
+    switch (sortRole) {
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize:
+        ret = compare(sizes[l], sizes[r]);
+        break;
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastModified:
+        ret = compare(lastModifiedSecs[l], lastModifiedSecs[r]);
+        if (ret == 0)
+            ret = compare(lastModifiedNsecs[l], lastModifiedNsecs[r]);
+        break;
+    case DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileLastRead:
+        ret = compare(lastReadSecs[l], lastReadSecs[r]);
+        if (ret == 0)
+            ret = compare(lastReadNsecs[l], lastReadNsecs[r]);
+        break;
+    default:
+        break;
+    }
+    if (ret != 0)
+        return ret;
+
+    // kSortRoleCompareDefault keeps the read order
+    if (sortKeyOffsets.empty())
+        return compare(left, right);
+
+    const size_t leftSize = sortKeyOffsets[l + 1] - sortKeyOffsets[l];
+    const size_t rightSize = sortKeyOffsets[r + 1] - sortKeyOffsets[r];
+    ret = memcmp(sortKeys.data() + sortKeyOffsets[l], sortKeys.data() + sortKeyOffsets[r], qMin(leftSize, rightSize));
+    if (ret != 0)
+        return ret;
+    return compare(leftSize, rightSize);
+}
+
+bool DFileTablePrivate::lessThan(int left, int right) const
+{
+    if (!sortMixDirAndFile) {
+        const bool leftIsDir = testFlag(left, kIsDir);
+        if (leftIsDir != testFlag(right, kIsDir))
+            return leftIsDir;
+    }
+
+    const int ret = compareRows(left, right);
+    return sortOrder == Qt::DescendingOrder ? ret > 0 : ret < 0;
+}
+
+void DFileTablePrivate::sortUntil(int count)
+{
+    count = qBound(0, count, this->count());
+    if (count <= sortedCount)
+        return;
+
+    // only the rows asked for are selected and sorted, a heap over the rest costs n·log(k), not n·log(n)
+    auto less = [this](int left, int right) { return lessThan(left, right); };
+    auto begin = order.begin() + sortedCount;
+    if (count == this->count())
+        std::sort(begin, order.end(), less);
+    else
+        std::partial_sort(begin, order.begin() + count, order.end(), less);
+    sortedCount = count;
+}
+
+/************************************************
+ * DFileTable::Row
+ ***********************************************/
+
+DFileTable::Row::Row(const DFileTablePrivate *table, int index)
+    : table(table), index(index)
+{
+}
+
+const char *DFileTable::Row::name() const
+{
+    return table->name(index);
+}
+
+int DFileTable::Row::nameLength() const
+{
+    return table->nameLength(index);
+}
+
+QString DFileTable::Row::fileName() const
+{
+    return table->fileName(index);
+}
+
+QUrl DFileTable::Row::url() const
+{
+    return QUrl::fromLocalFile(QString::fromUtf8(table->filePath(index)));
+}
+
+qint64 DFileTable::Row::size() const
+{
+    return table->sizes[static_cast<size_t>(index)];
+}
+
+quint32 DFileTable::Row::mode() const
+{
+    return table->modes[static_cast<size_t>(index)];
+}
+
+quint64 DFileTable::Row::inode() const
+{
+    return table->inodes[static_cast<size_t>(index)];
+}
+
+uint DFileTable::Row::uid() const
+{
+    return table->uids[static_cast<size_t>(index)];
+}
+
+uint DFileTable::Row::gid() const
+{
+    return table->gids[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::lastRead() const
+{
+    return table->lastReadSecs[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::lastReadNs() const
+{
+    return table->lastReadNsecs[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::lastModified() const
+{
+    return table->lastModifiedSecs[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::lastModifiedNs() const
+{
+    return table->lastModifiedNsecs[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::created() const
+{
+    return table->createdSecs[static_cast<size_t>(index)];
+}
+
+qint64 DFileTable::Row::createdNs() const
+{
+    return table->createdNsecs[static_cast<size_t>(index)];
+}
+
+bool DFileTable::Row::isDir() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsDir);
+}
+
+bool DFileTable::Row::isFile() const
+{
+    return !isDir();
+}
+
+bool DFileTable::Row::isSymLink() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsSymLink);
+}
+
+bool DFileTable::Row::isHide() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsHide);
+}
+
+bool DFileTable::Row::isReadable() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsReadable);
+}
+
+bool DFileTable::Row::isWriteable() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsWriteable);
+}
+
+bool DFileTable::Row::isExecutable() const
+{
+    return table->testFlag(index, DFileTablePrivate::kIsExecutable);
+}
+
+QUrl DFileTable::Row::symlinkUrl() const
+{
+    const auto it = table->symlinkTargets.constFind(index);
+    if (it == table->symlinkTargets.constEnd())
+        return QUrl();
+    return QUrl::fromLocalFile(QString::fromUtf8(it.value()));
+}
+
+QSharedPointer<DEnumerator::SortFileInfo> DFileTable::Row::toSortFileInfo() const
+{
+    auto sortPointer = QSharedPointer<DEnumerator::SortFileInfo>(new DEnumerator::SortFileInfo);
+    sortPointer->url = url();
+    sortPointer->filesize = size();
+    sortPointer->isFile = isFile();
+    sortPointer->isDir = isDir();
+    sortPointer->isSymLink = isSymLink();
+    sortPointer->isHide = isHide();
+    sortPointer->isReadable = isReadable();
+    sortPointer->isWriteable = isWriteable();
+    sortPointer->isExecutable = isExecutable();
+    sortPointer->inode = inode();
+    sortPointer->symlinkUrl = symlinkUrl();
+    sortPointer->gid = gid();
+    sortPointer->uid = uid();
+    sortPointer->lastRead = lastRead();
+    sortPointer->lastReadNs = lastReadNs();
+    sortPointer->lastModifed = lastModified();
+    sortPointer->lastModifedNs = lastModifiedNs();
+    sortPointer->create = created();
+    sortPointer->createNs = createdNs();
+    return sortPointer;
+}
+
+/************************************************
+ * DFileTable
+ ***********************************************/
+
+DFileTable::DFileTable()
+    : d(new DFileTablePrivate)
+{
+}
+
+DFileTable::DFileTable(const QUrl &dirUrl)
+    : d(new DFileTablePrivate)
+{
+    d->dirUrl = dirUrl;
+    d->dirPath = dirUrl.path().toUtf8();
+}
+
+DFileTable::DFileTable(const DFileTable &other) = default;
+
+DFileTable &DFileTable::operator=(const DFileTable &other) = default;
+
+DFileTable::~DFileTable() = default;
+
+QUrl DFileTable::dirUrl() const
+{
+    return d->dirUrl;
+}
+
+int DFileTable::count() const
+{
+    return d->count();
+}
+
+bool DFileTable::isEmpty() const
+{
+    return d->count() == 0;
+}
+
+DFileTable::Row DFileTable::row(int pos) const
+{
+    return Row(d.constData(), d->order[static_cast<size_t>(pos)]);
+}
+
+void DFileTable::sort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile)
+{
+    partialSort(role, order, mixDirAndFile, count());
+}
+
+void DFileTable::partialSort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile, int count)
+{
+    DFileTablePrivate *table = d.data();
+    table->prepareSort(role, order, mixDirAndFile);
+    table->sortUntil(count);
+}
+
+void DFileTable::sortMore(int count)
+{
+    if (count > d->sortedCount)
+        d->sortUntil(count);
+}
+
+int DFileTable::sortedCount() const
+{
+    return d->sortedCount;
+}
+
+QList<QSharedPointer<DEnumerator::SortFileInfo>> DFileTable::toSortFileInfoList() const
+{
+    QList<QSharedPointer<DEnumerator::SortFileInfo>> list;
+    list.reserve(count());
+    for (int pos = 0; pos < count(); ++pos)
+        list.append(row(pos).toSortFileInfo());
+    return list;
+}
@@ -5,6 +5,7 @@
 #include "private/doperator_p.h"
 
 #include "utils/dlocalhelper.h"
+#include "utils/dattributetable.h"
 
 #include <QFile>
 #include <QTextStream>
@@ -518,9 +519,9 @@ bool DOperator::setFileInfo(const DFileInfo &fileInfo)
     g_autoptr(GFile) gfile = d->makeGFile(uri);
 
     bool ret = true;
-    for (const auto &[key, value] : DLocalHelper::attributeInfoMapFunc()) {
+    for (const auto &desc : kAttributeDescriptors) {
         g_autoptr(GError) gerror = nullptr;
-        bool succ = DLocalHelper::setAttributeByGFile(gfile, key, fileInfo.attribute(key, nullptr), &gerror);
+        bool succ = DLocalHelper::setAttributeByGFile(gfile, desc.id, fileInfo.attribute(desc.id, nullptr), &gerror);
         if (!succ)
             ret = false;
         if (gerror)
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDIRECTORYSIZER_P_H
+#define DDIRECTORYSIZER_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/ddirectorysizer.h>
+
+#include "utils/dworkstealingqueue.h"
+
+#include <QElapsedTimer>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+BEGIN_IO_NAMESPACE
+
+class DDirectorySizerPrivate
+{
+public:
+    // counted by one worker, added to the totals once per directory
+    struct Counter
+    {
+        qint64 totalSize { 0 };
+        qint64 allocatedSize { 0 };
+        qint64 fileCount { 0 };
+        qint64 dirCount { 0 };
+    };
+
+    explicit DDirectorySizerPrivate(DDirectorySizer *q);
+    ~DDirectorySizerPrivate();
+
+    void workerLoop(int worker);
+    void processDir(const std::string &path, int worker);
+    // false if (dev, inode) was counted before
+    bool markLinked(uint64_t dev, uint64_t inode);
+    void flush(Counter *counter);
+    void finishDir();
+    void stop();
+
+public:
+    DDirectorySizer *q { nullptr };
+    QUrl url;
+    int threadCount { 4 };
+    bool oneFileSystem { false };
+    int progressInterval { 100 };   // ms
+    DFMIOError error;
+
+    uint64_t rootDev { 0 };
+    QScopedPointer<DWorkStealingQueue<std::string>> tasks;
+    std::vector<std::thread> workers;
+
+    // guards the end of a run: pendingDirs, liveWorkers, the changes of running and canceled, and error
+    std::mutex lock;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    size_t pendingDirs { 0 };
+    size_t liveWorkers { 0 };
+    std::atomic_bool running { false };
+    std::atomic_bool canceled { false };
+    std::atomic_bool destroying { false };   // no signal is emitted once set
+
+    std::atomic<qint64> totalSize { 0 };
+    std::atomic<qint64> allocatedSize { 0 };
+    std::atomic<qint64> fileCount { 0 };
+    std::atomic<qint64> dirCount { 0 };
+
+    QElapsedTimer timer;
+    std::atomic<qint64> lastProgress { 0 };
+
+    struct LinkShard
+    {
+        std::mutex lock;
+        std::set<std::pair<uint64_t, uint64_t>> inodes;
+    };
+    std::array<LinkShard, 16> linked;   // sharded by inode, workers rarely meet on one lock
+};
+
+END_IO_NAMESPACE
+
+#endif   // DDIRECTORYSIZER_P_H
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDIRSNAPSHOT_P_H
+#define DDIRSNAPSHOT_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/ddirsnapshot.h>
+
+#include <QSharedData>
+#include <QHash>
+#include <QByteArray>
+
+#include <atomic>
+#include <vector>
+
+BEGIN_IO_NAMESPACE
+
+class DDirSnapshotPrivate : public QSharedData
+{
+public:
+    struct Entry
+    {
+        quint64 inode { 0 };
+        qint64 size { 0 };
+        qint64 mtimeSec { 0 };
+        quint32 mtimeNsec { 0 };
+        qint64 ctimeSec { 0 };
+        quint32 ctimeNsec { 0 };
+    };
+
+    // read the directory again, fill delta against the entries taken before if it is not null,
+    // returns 0 or the errno
+    int scan(DDirSnapshot::Delta *delta, const std::atomic_bool &canceled);
+
+public:
+    QUrl dirUrl;
+    QByteArray dirPath;
+    bool valid { false };
+    QHash<QByteArray, Entry> entries;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DDIRSNAPSHOT_P_H
@@ -7,6 +7,12 @@
 
 #include <dfm-io/dfmio_global.h>
 #include <dfm-io/denumerator.h>
+#include <dfm-io/dfileinfo.h>
+#include <dfm-io/dfiletable.h>
+
+#include "utils/dlocaldirreader.h"
+#include "utils/dentryfilter.h"
+#include "utils/dlocalparallelwalker.h"
 
 #include <QList>
 #include <QMap>
@@ -16,6 +22,9 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QPointer>
+#include <QScopedPointer>
+#include <QElapsedTimer>
+#include <QFuture>
 
 #include <gio/gio.h>
 #include <fts.h>
@@ -35,6 +44,14 @@ public:
         GFileEnumerator *enumerator { nullptr };
     };
 
+    struct LocalDirNode
+    {
+        explicit LocalDirNode(size_t bufferSize = DLocalDirReader::kDefaultBufferSize)
+            : reader(bufferSize) { }
+        QByteArray path;
+        DLocalDirReader reader;
+    };
+
 public:
     explicit DEnumeratorPrivate(DEnumerator *q);
     ~DEnumeratorPrivate();
@@ -42,19 +59,46 @@ public:
     bool init();
     void clean();
     bool createEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me);
+    bool createLocalEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me);
+    bool isLocalEnumerator() const;
+    bool hasNextLocal();
+    bool createParallelEnumerator(const QUrl &url, QPointer<DEnumeratorPrivate> me);
+    bool isParallelEnumerator() const;
+    bool hasNextParallel();
+    // path is relative to dirFd, name is the bare file name
+    bool checkLocalFilter(int dirFd, const char *path, const char *name, size_t nameLength, unsigned char type, const QByteArray &dirPath);
     void checkAndResetCancel();
     void setErrorFromGError(GError *gerror);
-    bool checkFilter();
+    bool checkFilter(GFileInfo *gfileInfo, GFile *dir);
+    DEntryFilter &compiledFilter();
+    void useHideListOf(const QByteArray &dirPath);
+    void useHideListOf(GFile *dir);
+    // false if the directory of dirFd was walked before, (dev, ino) as DLocalParallelWalker does
+    static bool markVisited(int dirFd, QSet<QPair<quint64, quint64>> *visited);
+    GFile *uriFile();
     bool openDirByfts();
-    void insertSortFileInfoList(QList<QSharedPointer<DEnumerator::SortFileInfo>> &fileList,
-                                QList<QSharedPointer<DEnumerator::SortFileInfo>> &dirList,
-                                FTSENT *ent,
-                                FTS *fts, const QSet<QString> &hideList);
+    // same entries as hasNext() on a local uri, only counted
+    quint64 countLocal();
+    quint64 countParallel();
+    DFileTable readFileTable();
+    bool pageSortChanged() const;
+    // sort the rows after the requested pages in the background
+    void startPageFill();
+    void stopPageFill();
     void enumUriAsyncOvered(GList *files);
+    void nextFilesAsync(EnumUriData *data);
+    int adaptBatchSize(int received);
+    QUrl asyncChildUrl(GFileInfo *gfileInfo) const;
     void startAsyncIterator();
     bool hasNext();
     QList<QSharedPointer<DFileInfo>> fileInfoList();
     void setQueryAttributes(const QString &attributes);
+    // built by the setters, never while enumerating
+    const char *projectedAttributes() const;
+    void updateProjection();
+    // the caller's attributes, without what the filters need
+    QByteArray requestedAttributes() const;
+    QByteArray buildProjection() const;
 
     static void enumUriAsyncCallBack(GObject *sourceObject,
                                      GAsyncResult *res,
@@ -66,6 +110,7 @@ public:
 
 Q_SIGNALS:
     void asyncIteratorOver();
+    void asyncBatchReady(const QList<QSharedPointer<DFileInfo>> &infos);
 
 public:
     DEnumerator *q { nullptr };
@@ -75,11 +120,24 @@ public:
 
     GCancellable *cancellable { nullptr };
     QStack<GFileEnumerator *> stackEnumerator;
+    QStack<LocalDirNode *> stackLocalDir;
+    QSet<QPair<quint64, quint64>> visitedDirs;   // by hasNextLocal(), only if following symlinks
+    QScopedPointer<DLocalParallelWalker> walker;
+    DLocalParallelWalker::Batch walkerBatch;
+    size_t walkerBatchPos { 0 };
     QSharedPointer<DFileInfo> dfileInfoNext { nullptr };
-    QMap<QUrl, QSet<QString>> hideListMap;
+    QMap<QByteArray, QSet<QString>> hideListMap;   // directory path -> names in its .hidden, bounded
+    QByteArray hideListDir;
+    GFile *hideListOwner { nullptr };
+    GFile *uriGFile { nullptr };
+    DEntryFilter entryFilter;
+    bool filterDirty { true };
     QList<QSharedPointer<DFileInfo>> infoList;
     QList<GFileInfo *> asyncInfos;
     QString queryAttributes;
+    QList<DFileInfo::AttributeID> queryAttributeIds;
+    bool customQueryAttributes { false };
+    QByteArray projection;   // attributes really passed to gio, built from the above and the filters
 
     QStringList nameFilters;
     DEnumerator::DirFilters dirFilters { DEnumerator::DirFilter::kNoFilter };
@@ -90,23 +148,30 @@ public:
 
     QUrl uri;
     QUrl nextUrl;
+    QByteArray nextPath;   // only for system enumerator, nextUrl is created from it lazily
+    struct statx nextStat {};
+    unsigned int nextStatMask { 0 };
+    DEnumerator::EnumeratorType enumeratorType { DEnumerator::EnumeratorType::kEnumeratorGio };
+    int threadCount { 1 };
+    bool orderedResults { false };
     ulong enumTimeout { 0 };
     bool ftsCanceled { false };
     std::atomic_bool inited { false };
     FTS *fts { nullptr };
+    QScopedPointer<DFileTable> pageTable;   // read once by sortFileInfoPage()
+    QMutex pageMutex;
+    QFuture<void> pageFuture;
+    std::atomic_bool pageCanceled { false };
     bool enumSubDir { false };
     bool enumLinks { false };
     std::atomic_bool async { false };
     std::atomic_bool asyncStoped { false };
     std::atomic_bool asyncOvered { false };
-
-private:
-    bool shouldShowDotAndDotDot(const QString &fileName);
-    bool checkEntryTypeFilter();
-    bool checkPermissionFilter();
-    bool checkSymlinkFilter();
-    bool checkHiddenFilter();
-    bool checkNameFilter(const QString &fileName);
+    std::atomic_bool localCanceled { false };
+    int batchSize { 100 };
+    int requestedBatchSize { 100 };
+    bool adaptiveBatchSize { true };
+    QElapsedTimer batchTimer;
 };
 
 END_IO_NAMESPACE
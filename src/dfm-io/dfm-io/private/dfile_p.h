@@ -11,9 +11,13 @@
 
 #include <gio/gio.h>
 
+#include <atomic>
+#include <mutex>
+
 BEGIN_IO_NAMESPACE
 
 class DFile;
+class DUringEngine;
 
 class DFilePrivate : public QObject
 {
@@ -69,6 +73,17 @@ public:
     DFile::Permissions permissionsFromGFileInfo(GFileInfo *gfileinfo);
     bool checkOpenFlags(DFile::OpenFlags *modeIn);
     quint32 buildPermissions(DFile::Permissions permission);
+    // the fd of a local file stream, -1 for other backends
+    static int streamFd(gpointer stream);
+    // the io_uring engine and the fd of stream if asyncEngine is kIoUring and both are usable
+    DUringEngine *uringEngine(gpointer stream, int *fd) const;
+    // the fd of the open input or output stream, or of the closed local file in *ownFd to be closed by the caller.
+    // -1 for other backends
+    int adviceFd(bool openOnly, int *ownFd);
+    // readv() and writev() of local files, -1 and error set on failure
+    qint64 doPositional(bool write, qint64 offset, const DFile::Segment *segments, int count);
+    // positional io runs on several threads at once, its errors are set under errorLock
+    void setPositionalError(DFMIOErrorCode code);
 
     bool doOpen(DFile::OpenFlags mode);
     bool doClose();
@@ -95,9 +110,12 @@ public:
     GOutputStream *oStream { nullptr };
     GCancellable *cancellable { nullptr };
     DFMIOError error;
+    std::mutex errorLock;
     QByteArray readAllAsyncRet;
     QUrl uri;
     bool isOpen { false };
+    DFile::AsyncEngine asyncEngine { DFile::AsyncEngine::kGio };
+    std::atomic_int uringPending { 0 };   // io_uring requests not reported yet, close() fails meanwhile
 };
 
 END_IO_NAMESPACE
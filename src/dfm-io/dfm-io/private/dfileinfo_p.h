@@ -14,17 +14,39 @@
 #include <QVariant>
 #include <QSharedData>
 #include <QPointer>
+#include <QSet>
 
 #include <gio/gio.h>
+#include <sys/stat.h>
 
 #include <unordered_map>
 #include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 BEGIN_IO_NAMESPACE
 
 class DFileInfoPrivate : public QObject, public QSharedData
 {
 public:
+    // attribute values of one query, indexed by attributeSlot(). a slot is written once, a new query
+    // installs a new cache, so a set bit in present means the value can be read without locking
+    struct AttributeCache
+    {
+        explicit AttributeCache(int size)
+            : values(new QVariant[static_cast<size_t>(size)]), present(static_cast<size_t>(size + 63) / 64) { }
+        bool has(int slot) const
+        {
+            return present[static_cast<size_t>(slot) / 64].load(std::memory_order_acquire) & (quint64(1) << (slot % 64));
+        }
+
+        std::unique_ptr<QVariant[]> values;
+        std::vector<std::atomic<quint64>> present;
+        std::mutex lock;   // writers only
+    };
+
     typedef struct
     {
         DFileInfo::InitQuerierAsyncCallback callback;
@@ -47,12 +69,23 @@ public:
     [[nodiscard]] DFileFuture *attributeExtend(DFileInfo::MediaType type, QList<DFileInfo::AttributeExtendID> ids, int ioPriority, QObject *parent = nullptr);
     bool cancelAttributeExtend();
     bool cancelAttributes();
-    void attributeExtendCallback();
+    void attributeExtendCallback(bool opened);
+    // stats the media file and looks it up in DMediaInfoCache, the stat is kept as key for the parsed values
+    bool cachedMediaValues(const QString &filePath, QMap<DFileInfo::AttributeExtendID, QVariant> *map);
 
     void setErrorFromGError(GError *gerror);
     bool queryInfoSync();
     void queryInfoAsync(int ioPriority = 0, DFileInfo::InitQuerierAsyncCallback func = nullptr, void *userData = nullptr);
     QVariant attributesBySelf(DFileInfo::AttributeID id);
+    static bool isStatAttribute(DFileInfo::AttributeID id);
+    // one statx per refresh serves all time, size, mode, owner and inode attributes of local files
+    bool localStat(struct statx *st);
+    void resetLocalStat();
+    // a statx of the same mask done by someone else, e.g. DFileInfoBatch
+    void setLocalStat(const struct statx &st);
+    QVariant attributeFromStat(DFileInfo::AttributeID id);
+    // locks mutex itself, the query runs without it
+    void loadLazyAttribute(DFileInfo::AttributeID id);
     QVariant attributesFromUrl(DFileInfo::AttributeID id);
     void checkAndResetCancel();
 
@@ -60,6 +93,14 @@ public:
     [[nodiscard]] QFuture<void> refreshAsync();
 
     void cacheAttributes();
+    static int attributeSlot(DFileInfo::AttributeID id);
+    static int attributeSlotCount();
+    bool cachedAttribute(DFileInfo::AttributeID id, QVariant *value) const;
+    // the cached value itself, *holder keeps the cache alive while it is read
+    const QVariant *cachedValue(DFileInfo::AttributeID id, std::shared_ptr<AttributeCache> *holder) const;
+    void cacheAttribute(DFileInfo::AttributeID id, const QVariant &value, quint64 generation);
+    // the file info was queried again, drop everything derived from the last query
+    void resetCaches();
     DFile::Permissions permissions() const;
     bool exists() const;
 
@@ -80,6 +121,7 @@ public:
     DFileFuture *future = nullptr;
     DFileInfo::MediaType mediaType = DFileInfo::MediaType::kGeneral;
     DFileInfo::AttributeExtendFuncCallback attributeExtendFuncCallback { nullptr };
+    struct statx mediaStat {};   // of the file mediaInfo reads, invalid if stx_mask is 0
 
     QList<DFileInfo::AttributeID> attributesRealizationSelf;
     QList<DFileInfo::AttributeID> attributesNoBlockIO;
@@ -93,10 +135,18 @@ public:
     QFuture<void> futureRefresh;
     std::atomic_bool stoped { false };
     std::atomic_bool fileExists { false };
-    QMap<DFileInfo::AttributeID, QVariant> caches;
-    std::atomic_bool cacheing { false };
+    std::atomic_bool existsCached { false };
+    std::shared_ptr<AttributeCache> attributeCache;   // only by std::atomic_load/atomic_store
+    std::atomic<quint64> cacheGeneration { 0 };
     std::atomic_bool refreshing { false };
     QMutex mutex;
+    // namespaces loaded on demand into gfileinfo, when it was queried with a part of the attributes
+    GFileInfo *lazyInfo { nullptr };
+    QSet<QByteArray> lazyNamespaces;
+    GFileAttributeMatcher *queriedMatcher { nullptr };   // of attributes, built on first use
+    struct statx localStatBuffer {};
+    bool localStatDone { false };
+    bool localStatValid { false };
 
     DFMIOError error;
 };
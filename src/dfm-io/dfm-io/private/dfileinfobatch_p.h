@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEINFOBATCH_P_H
+#define DFILEINFOBATCH_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfobatch.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+BEGIN_IO_NAMESPACE
+
+class DFileInfoBatchPrivate
+{
+public:
+    // urls of one parent directory, large directories are split so that several workers share them
+    struct Group
+    {
+        bool local { false };
+        std::string dirPath;   // local groups only
+        QList<QUrl> urls;
+        std::vector<std::string> names;   // local groups only, the names of urls in dirPath
+    };
+
+    struct Mount
+    {
+        int limit { 1 };
+        int running { 0 };
+        std::deque<Group> pending;
+    };
+
+    explicit DFileInfoBatchPrivate(DFileInfoBatch *q);
+    ~DFileInfoBatchPrivate();
+
+    void buildGroups();
+    void workerLoop();
+    // a group of a mount below its limit, false when nothing is left
+    bool takeGroup(Group *group, size_t *mountIndex);
+    void finishGroup(size_t mountIndex, int count);
+    void processLocal(const Group &group);
+    void processRemote(const Group &group);
+    void report(const QList<QSharedPointer<DFileInfo>> &infos, const QList<QUrl> &failed);
+    QByteArray attributeString() const;
+    bool needsQuery() const;
+    void stop();
+
+public:
+    DFileInfoBatch *q { nullptr };
+    QList<QUrl> urls;
+    QList<DFileInfo::AttributeID> attributeIds;
+    DFileInfo::FileQueryInfoFlags flag { DFileInfo::FileQueryInfoFlags::kTypeNone };
+    QByteArray attributes;
+    bool queryNeeded { true };
+    int threadCount { 8 };
+    int mountConcurrency { 4 };
+    int remoteMountConcurrency { 2 };
+    DFMIOError error;
+
+    std::vector<Mount> mounts;
+    size_t nextMount { 0 };   // round robin, every mount gets its turn
+    int pendingUrls { 0 };
+    int liveWorkers { 0 };
+    std::atomic_int finishedCount { 0 };
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable workCondition;
+    std::condition_variable doneCondition;
+    std::atomic_bool running { false };
+    std::atomic_bool canceled { false };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILEINFOBATCH_P_H
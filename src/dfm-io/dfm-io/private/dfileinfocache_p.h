@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEINFOCACHE_P_H
+#define DFILEINFOCACHE_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfocache.h>
+#include <dfm-io/dwatcher.h>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+
+#include <list>
+
+BEGIN_IO_NAMESPACE
+
+class DFileInfoCachePrivate
+{
+public:
+    struct Entry
+    {
+        QUrl url;
+        QSharedPointer<const DFileInfo> info;
+        qint64 expires { 0 };   // on timer, 0 for never
+    };
+    using EntryList = std::list<Entry>;   // most recently used first
+
+    explicit DFileInfoCachePrivate(DFileInfoCache *q);
+
+    static QUrl keyOf(const QUrl &url);
+    static QUrl parentOf(const QUrl &key);
+
+    // all by lock
+    QSharedPointer<const DFileInfo> find(const QUrl &key);
+    void add(const QUrl &key, const QSharedPointer<const DFileInfo> &info);
+    void drop(EntryList::iterator it);
+    // adds delta to the counts of all directories above key
+    void countBelow(const QUrl &key, int delta);
+    // url, its parent directory whose times changed and, if url was a directory, everything below it
+    void invalidate(const QUrl &url, bool withChildren);
+
+public:
+    DFileInfoCache *q { nullptr };
+
+    mutable QMutex lock;
+    EntryList entries;
+    QHash<QUrl, EntryList::iterator> index;
+    QHash<QUrl, int> descendantCounts;   // cached entries at any depth below a directory, to skip the scan for files
+    int maxCount { 10000 };
+    int remoteTimeToLive { 5000 };
+    QElapsedTimer timer;
+
+    QHash<QUrl, DWatcher *> watchers;   // by watch(), in the thread of the cache
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILEINFOCACHE_P_H
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILEMAPPING_P_H
+#define DFILEMAPPING_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfilemapping.h>
+
+#include <QSharedData>
+
+BEGIN_IO_NAMESPACE
+
+class DFileMappingPrivate : public QSharedData
+{
+public:
+    ~DFileMappingPrivate();
+
+    // maps [offset, offset + size) of fd, mmap needs a page aligned start so more may be mapped,
+    // returns 0 or the errno
+    int map(int fd, qint64 offset, qint64 size);
+
+public:
+    bool valid { false };
+    void *mapped { nullptr };   // page aligned, null for an empty range
+    size_t mappedSize { 0 };
+    const char *data { nullptr };
+    qint64 size { 0 };
+    qint64 offset { 0 };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILEMAPPING_P_H
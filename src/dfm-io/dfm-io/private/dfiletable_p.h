@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DFILETABLE_P_H
+#define DFILETABLE_P_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfiletable.h>
+
+#include <QSharedData>
+#include <QHash>
+#include <QSet>
+
+#include <string>
+#include <vector>
+
+#include <fts.h>
+
+BEGIN_IO_NAMESPACE
+
+class DFileTablePrivate : public QSharedData
+{
+public:
+    enum Flag : uint8_t {
+        kIsDir = 0x01,
+        kIsSymLink = 0x02,
+        kIsHide = 0x04,
+        kIsReadable = 0x08,
+        kIsWriteable = 0x10,
+        kIsExecutable = 0x20,
+    };
+
+    // returns the index of the new row
+    int append(const FTSENT *ent, const QSet<QString> &hideList);
+    int count() const { return static_cast<int>(nameOffsets.size()); }
+    const char *name(int index) const { return names.data() + nameOffsets[static_cast<size_t>(index)]; }
+    int nameLength(int index) const;
+    QString fileName(int index) const;
+    QByteArray filePath(int index) const;
+    bool testFlag(int index, Flag flag) const { return flags[static_cast<size_t>(index)] & flag; }
+
+    void prepareSort(DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order, bool mixDirAndFile);
+    int compareRows(int left, int right) const;
+    // the complete order: directories first unless mixed, then role, then name key, then the sort order
+    bool lessThan(int left, int right) const;
+    // rows before count get their final position
+    void sortUntil(int count);
+
+public:
+    QUrl dirUrl;
+    QByteArray dirPath;
+
+    std::string names;   // '\0' separated
+    std::vector<quint32> nameOffsets;
+    std::vector<qint64> sizes;
+    std::vector<quint32> modes;
+    std::vector<quint64> inodes;
+    std::vector<quint32> uids;
+    std::vector<quint32> gids;
+    std::vector<qint64> lastReadSecs;
+    std::vector<quint32> lastReadNsecs;
+    std::vector<qint64> lastModifiedSecs;
+    std::vector<quint32> lastModifiedNsecs;
+    std::vector<qint64> createdSecs;
+    std::vector<quint32> createdNsecs;
+    std::vector<uint8_t> flags;
+    QHash<int, QByteArray> symlinkTargets;   // only symlinks have one
+
+    std::vector<int> order;   // sorted position -> row index
+    int sortedCount { 0 };   // order is final before it
+
+    DEnumerator::SortRoleCompareFlag sortRole { DEnumerator::SortRoleCompareFlag::kSortRoleCompareDefault };
+    Qt::SortOrder sortOrder { Qt::AscendingOrder };
+    bool sortMixDirAndFile { false };
+    std::string sortKeys;   // keys of DSortKeyBuilder, not changed until the next prepareSort()
+    std::vector<quint32> sortKeyOffsets;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DFILETABLE_P_H
@@ -0,0 +1,209 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DATTRIBUTETABLE_H
+#define DATTRIBUTETABLE_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QVariant>
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+
+BEGIN_IO_NAMESPACE
+
+// the value attribute() returns when an attribute can not be read
+enum class DAttributeDefault : uint8_t {
+    kZero,
+    kFalse,
+    kTrue,
+    kEmptyString,
+};
+
+struct DAttributeDescriptor
+{
+    DFileInfo::AttributeID id;
+    const char *key;   // G_FILE_ATTRIBUTE_*, custom attributes use the same form
+    DFileInfo::DFileAttributeType type;   // how the value is read from a GFileInfo, kTypeInvalid if it is not read from GIO
+    DAttributeDefault defaultValue;
+};
+
+// every attribute DFileInfo knows, sorted by id. the position of an attribute is its ordinal,
+// dense from 0 to kAttributeCount - 1
+inline constexpr DAttributeDescriptor kAttributeDescriptors[] = {
+    { DFileInfo::AttributeID::kStandardType, "standard::type", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardIsHidden, "standard::is-hidden", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsBackup, "standard::is-backup", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsSymlink, "standard::is-symlink", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsVirtual, "standard::is-virtual", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsVolatile, "standard::is-volatile", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardName, "standard::name", DFileInfo::DFileAttributeType::kTypeByteString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardDisplayName, "standard::display-name", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardEditName, "standard::edit-name", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardCopyName, "standard::copy-name", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardIcon, "standard::icon", DFileInfo::DFileAttributeType::kTypeObject, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardSymbolicIcon, "standard::symbolic-icon", DFileInfo::DFileAttributeType::kTypeObject, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardContentType, "standard::content-type", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardFastContentType, "standard::fast-content-type", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardSize, "standard::size", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardAllocatedSize, "standard::allocated-size", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardSymlinkTarget, "standard::symlink-target", DFileInfo::DFileAttributeType::kTypeByteString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardTargetUri, "standard::target-uri", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardSortOrder, "standard::sort-order", DFileInfo::DFileAttributeType::kTypeInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kStandardDescription, "standard::description", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kEtagValue, "etag::value", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kIdFile, "id::file", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kIdFilesystem, "id::filesystem", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kAccessCanRead, "access::can-read", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kTrue },
+    { DFileInfo::AttributeID::kAccessCanWrite, "access::can-write", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kTrue },
+    { DFileInfo::AttributeID::kAccessCanExecute, "access::can-execute", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kTrue },
+    { DFileInfo::AttributeID::kAccessCanDelete, "access::can-delete", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kTrue },
+    { DFileInfo::AttributeID::kAccessCanTrash, "access::can-trash", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kAccessCanRename, "access::can-rename", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kTrue },
+
+    { DFileInfo::AttributeID::kMountableCanMount, "mountable::can-mount", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableCanUnmount, "mountable::can-unmount", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableCanEject, "mountable::can-eject", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableUnixDevice, "mountable::unix-device", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kMountableUnixDeviceFile, "mountable::unix-device-file", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kMountableHalUdi, "mountable::hal-udi", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kMountableCanPoll, "mountable::can-poll", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableIsMediaCheckAutomatic, "mountable::is-media-check-automatic", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableCanStart, "mountable::can-start", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableCanStartDegraded, "mountable::can-start-degraded", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableCanStop, "mountable::can-stop", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kMountableStartStopType, "mountable::start-stop-type", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+
+    { DFileInfo::AttributeID::kTimeModified, "time::modified", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeModifiedUsec, "time::modified-usec", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeAccess, "time::access", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeAccessUsec, "time::access-usec", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeChanged, "time::changed", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeChangedUsec, "time::changed-usec", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeCreated, "time::created", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTimeCreatedUsec, "time::created-usec", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+
+    { DFileInfo::AttributeID::kOwnerUser, "owner::user", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kOwnerUserReal, "owner::user-real", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kOwnerGroup, "owner::group", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kUnixDevice, "unix::device", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixInode, "unix::inode", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixMode, "unix::mode", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixNlink, "unix::nlink", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixUID, "unix::uid", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixGID, "unix::gid", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixRdev, "unix::rdev", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixBlockSize, "unix::block-size", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixBlocks, "unix::blocks", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kUnixIsMountPoint, "unix::is-mountpoint", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+
+    { DFileInfo::AttributeID::kDosIsArchive, "dos::is-archive", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kDosIsSystem, "dos::is-system", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+
+    { DFileInfo::AttributeID::kThumbnailPath, "thumbnail::path", DFileInfo::DFileAttributeType::kTypeByteString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kThumbnailFailed, "thumbnail::failed", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kThumbnailIsValid, "thumbnail::is-valid", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+
+    { DFileInfo::AttributeID::kPreviewIcon, "preview::icon", DFileInfo::DFileAttributeType::kTypeObject, DAttributeDefault::kZero },
+
+    { DFileInfo::AttributeID::kFileSystemSize, "filesystem::size", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kFileSystemFree, "filesystem::free", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kFileSystemUsed, "filesystem::used", DFileInfo::DFileAttributeType::kTypeUInt64, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kFileSystemType, "filesystem::type", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kFileSystemReadOnly, "filesystem::readonly", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kFileSystemUsePreview, "filesystem::use-preview", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kFileSystemRemote, "filesystem::remote", DFileInfo::DFileAttributeType::kTypeBool, DAttributeDefault::kFalse },
+
+    { DFileInfo::AttributeID::kGvfsBackend, "gvfs::backend", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kSelinuxContext, "selinux::context", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kTrashItemCount, "trash::item-count", DFileInfo::DFileAttributeType::kTypeUInt32, DAttributeDefault::kZero },
+    { DFileInfo::AttributeID::kTrashDeletionDate, "trash::deletion-date", DFileInfo::DFileAttributeType::kTypeString, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kTrashOrigPath, "trash::orig-path", DFileInfo::DFileAttributeType::kTypeByteString, DAttributeDefault::kEmptyString },
+
+    { DFileInfo::AttributeID::kRecentModified, "recent::modified", DFileInfo::DFileAttributeType::kTypeInt64, DAttributeDefault::kZero },
+
+    { DFileInfo::AttributeID::kCustomStart, "custom-start", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kZero },
+
+    { DFileInfo::AttributeID::kStandardIsFile, "standard::is-file", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsDir, "standard::is-dir", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardIsRoot, "standard::is-root", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kFalse },
+    { DFileInfo::AttributeID::kStandardSuffix, "standard::suffix", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardCompleteSuffix, "standard::complete-suffix", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardFilePath, "standard::file-path", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardParentPath, "standard::parent-path", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardBaseName, "standard::base-name", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardFileName, "standard::file-name", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+    { DFileInfo::AttributeID::kStandardCompleteBaseName, "standard::complete-base-name", DFileInfo::DFileAttributeType::kTypeInvalid, DAttributeDefault::kEmptyString },
+};
+
+inline constexpr int kAttributeCount = static_cast<int>(std::size(kAttributeDescriptors));
+
+// AttributeID -> ordinal, -1 for ids without a descriptor
+inline constexpr auto kAttributeOrdinals = []() {
+    std::array<int16_t, static_cast<size_t>(DFileInfo::AttributeID::kAttributeIDMax) + 1> ordinals {};
+    for (auto &ordinal : ordinals)
+        ordinal = -1;
+    for (int i = 0; i < kAttributeCount; ++i)
+        ordinals[static_cast<size_t>(kAttributeDescriptors[i].id)] = static_cast<int16_t>(i);
+    return ordinals;
+}();
+
+// lookups are two array reads, nothing is allocated or copied
+class DAttributeTable
+{
+public:
+    static constexpr int ordinal(DFileInfo::AttributeID id)
+    {
+        const size_t index = static_cast<size_t>(id);
+        return index < kAttributeOrdinals.size() ? kAttributeOrdinals[index] : -1;
+    }
+
+    static constexpr const DAttributeDescriptor *descriptor(DFileInfo::AttributeID id)
+    {
+        const int i = ordinal(id);
+        return i < 0 ? nullptr : &kAttributeDescriptors[i];
+    }
+
+    // "" for ids without a descriptor
+    static constexpr const char *key(DFileInfo::AttributeID id)
+    {
+        const DAttributeDescriptor *desc = descriptor(id);
+        return desc ? desc->key : "";
+    }
+
+    static constexpr DFileInfo::DFileAttributeType type(DFileInfo::AttributeID id)
+    {
+        const DAttributeDescriptor *desc = descriptor(id);
+        return desc ? desc->type : DFileInfo::DFileAttributeType::kTypeInvalid;
+    }
+
+    // resolved at compile time, for call sites that name the attribute
+    template<DFileInfo::AttributeID id>
+    static constexpr const char *keyOf()
+    {
+        static_assert(ordinal(id) >= 0, "attribute has no descriptor");
+        return kAttributeDescriptors[ordinal(id)].key;
+    }
+
+    // invalid for ids without a descriptor
+    static QVariant defaultValue(DFileInfo::AttributeID id)
+    {
+        static const QVariant kDefaults[] { QVariant(0), QVariant(false), QVariant(true), QVariant(QString("")) };
+        const DAttributeDescriptor *desc = descriptor(id);
+        return desc ? kDefaults[static_cast<int>(desc->defaultValue)] : QVariant();
+    }
+};
+
+END_IO_NAMESPACE
+
+#endif   // DATTRIBUTETABLE_H
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dentryfilter.h"
+
+#include <gio/gio.h>
+
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+void DEntryFilter::compile(DEnumerator::DirFilters filters, const QStringList &nameFilters, bool followSymlinks)
+{
+    enabled = !filters.testFlag(DEnumerator::DirFilter::kNoFilter);
+    allDirs = filters.testFlag(DEnumerator::DirFilter::kAllDirs);
+    wantDirs = filters.testFlag(DEnumerator::DirFilter::kDirs);
+    wantFiles = filters.testFlag(DEnumerator::DirFilter::kFiles);
+    noSymlinks = filters.testFlag(DEnumerator::DirFilter::kNoSymLinks);
+    this->followSymlinks = followSymlinks;
+    showHidden = filters.testFlag(DEnumerator::DirFilter::kHidden);
+    noDot = filters.testFlag(DEnumerator::DirFilter::kNoDot);
+    noDotDot = filters.testFlag(DEnumerator::DirFilter::kNoDotDot);
+    caseSensitive = filters.testFlag(DEnumerator::DirFilter::kCaseSensitive);
+
+    accessMask = 0;
+    if (filters.testFlag(DEnumerator::DirFilter::kReadable))
+        accessMask |= R_OK;
+    if (filters.testFlag(DEnumerator::DirFilter::kWritable))
+        accessMask |= W_OK;
+    if (filters.testFlag(DEnumerator::DirFilter::kExecutable))
+        accessMask |= X_OK;
+
+    names.compile(nameFilters, caseSensitive);
+}
+
+bool DEntryFilter::acceptName(const DEntryFilter::Entry &entry) const
+{
+    const char *name = entry.name;
+    if (name[0] == '.') {
+        const bool isDot = entry.nameLength == 1;
+        const bool isDotDot = entry.nameLength == 2 && name[1] == '.';
+        if ((isDot && noDot) || (isDotDot && noDotDot))
+            return false;
+        if (!showHidden)
+            return false;
+    }
+
+    if (!showHidden && hideList && !hideList->isEmpty()) {
+        const QString &fileName = QString::fromUtf8(name, static_cast<int>(entry.nameLength));
+        if (hideList->contains(fileName))
+            return false;
+    }
+
+    // kAllDirs: 名称过滤不作用于目录
+    if (names.isEmpty() || allDirs)
+        return true;
+
+    return names.matches(name, entry.nameLength);
+}
+
+unsigned char DEntryFilter::typeFromGFileType(int gtype)
+{
+    switch (gtype) {
+    case G_FILE_TYPE_REGULAR:
+        return DT_REG;
+    case G_FILE_TYPE_DIRECTORY:
+        return DT_DIR;
+    case G_FILE_TYPE_SYMBOLIC_LINK:
+        return DT_LNK;
+    default:
+        return DT_UNKNOWN;
+    }
+}
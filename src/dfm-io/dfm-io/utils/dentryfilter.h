@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DENTRYFILTER_H
+#define DENTRYFILTER_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/denumerator.h>
+
+#include "utils/dnamematcher.h"
+
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <dirent.h>
+
+BEGIN_IO_NAMESPACE
+
+// DirFilters, name filters and hidden rules compiled once, checked on the raw data of an entry
+// before any DFileInfo is created. checks without io run first, the resolver is only called
+// for what is really needed
+class DEntryFilter
+{
+public:
+    enum class Need : uint8_t {
+        kTargetType,   // fill targetType of a symlink
+        kAccess,   // fill accessible, all of accessMode() must be granted
+    };
+
+    struct Entry
+    {
+        const char *name { nullptr };
+        size_t nameLength { 0 };
+        unsigned char type { DT_UNKNOWN };   // DT_*, DT_LNK for a symlink unless the backend followed it
+        bool isSymlink { false };
+        unsigned char targetType { DT_UNKNOWN };
+        bool accessible { false };
+    };
+
+    void compile(DEnumerator::DirFilters filters, const QStringList &nameFilters, bool followSymlinks);
+
+    bool isEnabled() const { return enabled; }
+    bool needsHideList() const { return enabled && !showHidden; }
+    int accessMode() const { return accessMask; }
+    void setHideList(const QSet<QString> *list) { hideList = list; }
+
+    static unsigned char typeFromGFileType(int gtype);
+
+    // resolver: bool (Entry &entry, Need need), returns false if the data can't be got
+    template<typename Resolver>
+    bool accept(Entry &entry, Resolver &&resolve) const
+    {
+        if (!enabled)
+            return true;
+
+        if (noSymlinks && entry.isSymlink)
+            return false;
+
+        if (!acceptName(entry))
+            return false;
+
+        if (!acceptType(entry, resolve))
+            return false;
+
+        if (accessMask != 0)
+            return resolve(entry, Need::kAccess) && entry.accessible;
+
+        return true;
+    }
+
+private:
+    bool acceptName(const Entry &entry) const;
+
+    template<typename Resolver>
+    bool acceptType(Entry &entry, Resolver &resolve) const
+    {
+        unsigned char type = entry.type;
+        if (entry.isSymlink && type == DT_LNK && (allDirs || followSymlinks))
+            type = resolve(entry, Need::kTargetType) ? entry.targetType : DT_UNKNOWN;
+
+        // kAllDirs: 显示所有目录，包括符号链接指向的目录
+        if (allDirs)
+            return type == DT_DIR;
+
+        if (!wantDirs && !wantFiles)
+            return false;
+        if (wantDirs && !wantFiles)
+            return type == DT_DIR;
+        if (!wantDirs && wantFiles)
+            return type == DT_REG;
+        return true;
+    }
+
+    bool enabled { false };
+    bool allDirs { false };
+    bool wantDirs { false };
+    bool wantFiles { false };
+    bool noSymlinks { false };
+    bool followSymlinks { false };
+    bool showHidden { true };
+    bool noDot { false };
+    bool noDotDot { false };
+    bool caseSensitive { false };
+    int accessMask { 0 };
+    DNameMatcher names;
+    const QSet<QString> *hideList { nullptr };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DENTRYFILTER_H
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dlocaldirreader.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace {
+struct LinuxDirent64
+{
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+}   // namespace
+
+DLocalDirReader::DLocalDirReader(size_t bufferSize)
+    : bufferSize(bufferSize < 4096 ? 4096 : bufferSize)
+{
+}
+
+DLocalDirReader::~DLocalDirReader()
+{
+    close();
+}
+
+bool DLocalDirReader::open(const char *path)
+{
+    return openAt(AT_FDCWD, path);
+}
+
+bool DLocalDirReader::openAt(int dirFd, const char *name)
+{
+    close();
+
+    do {
+        this->dirFd = ::openat(dirFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC | O_NOCTTY);
+    } while (this->dirFd < 0 && errno == EINTR);
+
+    if (this->dirFd < 0) {
+        err = errno;
+        return false;
+    }
+
+    if (!buffer)
+        buffer.reset(new char[bufferSize]);
+    return true;
+}
+
+void DLocalDirReader::close()
+{
+    if (dirFd >= 0)
+        ::close(dirFd);
+    dirFd = -1;
+    err = 0;
+    bufferPos = 0;
+    bufferEnd = 0;
+}
+
+bool DLocalDirReader::isOpen() const
+{
+    return dirFd >= 0;
+}
+
+int DLocalDirReader::fd() const
+{
+    return dirFd;
+}
+
+int DLocalDirReader::lastErrno() const
+{
+    return err;
+}
+
+bool DLocalDirReader::next(DLocalDirReader::Entry *entry)
+{
+    if (dirFd < 0 || !entry)
+        return false;
+
+    while (true) {
+        if (bufferPos >= bufferEnd && !fill())
+            return false;
+
+        const LinuxDirent64 *dirent = reinterpret_cast<const LinuxDirent64 *>(buffer.get() + bufferPos);
+        bufferPos += dirent->d_reclen;
+
+        const char *name = dirent->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+            continue;
+
+        entry->name = name;
+        entry->nameLength = strlen(name);
+        entry->type = dirent->d_type;
+        entry->inode = dirent->d_ino;
+        return true;
+    }
+}
+
+bool DLocalDirReader::stat(const DLocalDirReader::Entry &entry, unsigned int mask, bool followSymlinks, struct statx *st) const
+{
+    return statAt(dirFd, entry.name, mask, followSymlinks, st);
+}
+
+bool DLocalDirReader::statAt(int dirFd, const char *name, unsigned int mask, bool followSymlinks, struct statx *st)
+{
+    const int flags = AT_NO_AUTOMOUNT | (followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+    int ret = 0;
+    do {
+        ret = ::statx(dirFd, name, flags, mask, st);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret == 0;
+}
+
+unsigned char DLocalDirReader::typeFromMode(mode_t mode)
+{
+    switch (mode & S_IFMT) {
+    case S_IFREG:
+        return DT_REG;
+    case S_IFDIR:
+        return DT_DIR;
+    case S_IFLNK:
+        return DT_LNK;
+    case S_IFCHR:
+        return DT_CHR;
+    case S_IFBLK:
+        return DT_BLK;
+    case S_IFIFO:
+        return DT_FIFO;
+    case S_IFSOCK:
+        return DT_SOCK;
+    default:
+        return DT_UNKNOWN;
+    }
+}
+
+bool DLocalDirReader::fill()
+{
+    long nread = 0;
+    do {
+        nread = ::syscall(SYS_getdents64, dirFd, buffer.get(), bufferSize);
+    } while (nread < 0 && errno == EINTR);
+
+    bufferPos = 0;
+    if (nread <= 0) {
+        err = nread < 0 ? errno : 0;
+        bufferEnd = 0;
+        return false;
+    }
+
+    bufferEnd = static_cast<size_t>(nread);
+    return true;
+}
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLOCALDIRREADER_H
+#define DLOCALDIRREADER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <memory>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+BEGIN_IO_NAMESPACE
+
+// read raw dirents of a local directory by getdents64, no GFileInfo/DFileInfo is created
+class DLocalDirReader
+{
+public:
+    struct Entry
+    {
+        const char *name { nullptr };   // valid until the next call of next()
+        size_t nameLength { 0 };
+        unsigned char type { DT_UNKNOWN };
+        uint64_t inode { 0 };
+    };
+
+    static constexpr size_t kDefaultBufferSize = 32 * 1024;
+
+    explicit DLocalDirReader(size_t bufferSize = kDefaultBufferSize);
+    ~DLocalDirReader();
+
+    DLocalDirReader(const DLocalDirReader &) = delete;
+    DLocalDirReader &operator=(const DLocalDirReader &) = delete;
+
+    bool open(const char *path);
+    bool openAt(int dirFd, const char *name);
+    void close();
+    bool isOpen() const;
+    int fd() const;
+    int lastErrno() const;
+
+    // "." and ".." are always skipped
+    bool next(Entry *entry);
+    bool stat(const Entry &entry, unsigned int mask, bool followSymlinks, struct statx *st) const;
+
+    static bool statAt(int dirFd, const char *name, unsigned int mask, bool followSymlinks, struct statx *st);
+    static unsigned char typeFromMode(mode_t mode);
+
+private:
+    bool fill();
+
+    int dirFd { -1 };
+    int err { 0 };
+    size_t bufferSize { 0 };
+    size_t bufferPos { 0 };
+    size_t bufferEnd { 0 };
+    std::unique_ptr<char[]> buffer;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLOCALDIRREADER_H
@@ -38,9 +38,6 @@ std::function<Ret(Ts...)> bind_field(Ret (*m)(Ts...))
 class DLocalHelper
 {
 public:
-    using AttributeInfoMap = std::unordered_map<DFileInfo::AttributeID, std::tuple<std::string, QVariant>>;
-
-    static AttributeInfoMap &attributeInfoMapFunc();
     static QSharedPointer<DFileInfo> createFileInfoByUri(const QUrl &uri, const char *attributes = "*",
                                                          const DFMIO::DFileInfo::FileQueryInfoFlags flag = DFMIO::DFileInfo::FileQueryInfoFlags::kTypeNone);
     static QSharedPointer<DFileInfo> createFileInfoByUri(const QUrl &uri, GFileInfo *gfileInfo, const char *attributes = "*",
@@ -51,7 +48,6 @@ public:
     static QVariant customAttributeFromPathAndInfo(const QString &path, GFileInfo *fileInfo, DFileInfo::AttributeID id);
     static bool setAttributeByGFile(GFile *gfile, DFileInfo::AttributeID id, const QVariant &value, GError **error);
     static bool setAttributeByGFileInfo(GFileInfo *gfileinfo, DFileInfo::AttributeID id, const QVariant &value);
-    static std::string attributeStringById(DFileInfo::AttributeID id);
     static QSet<QString> hideListFromUrl(const QUrl &url);
     static bool fileIsHidden(const DFileInfo *dfileinfo, const QSet<QString> &hideList, const bool needRead = true);
 
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dlocalparallelwalker.h"
+#include "utils/dlocaldirreader.h"
+
+#include <cerrno>
+
+USING_IO_NAMESPACE
+
+void DLocalParallelWalker::Batch::clear()
+{
+    dirPath.clear();
+    names.clear();
+    offsets.clear();
+    types.clear();
+}
+
+DLocalParallelWalker::DLocalParallelWalker(const std::string &rootPath, const Options &options)
+    : root(rootPath),
+      opts(options),
+      tasks(options.threadCount)
+{
+    if (opts.threadCount < 1)
+        opts.threadCount = 1;
+    if (opts.batchSize < 1)
+        opts.batchSize = 1;
+    if (opts.queueCapacity < 1)
+        opts.queueCapacity = 1;
+    while (root.size() > 1 && root.back() == '/')
+        root.pop_back();
+}
+
+DLocalParallelWalker::~DLocalParallelWalker()
+{
+    stop();
+}
+
+bool DLocalParallelWalker::start()
+{
+    if (started)
+        return true;
+
+    DLocalDirReader probe;
+    if (!probe.open(root.c_str())) {
+        error = probe.lastErrno();
+        return false;
+    }
+    probe.close();
+
+    NodePtr node = std::make_shared<Node>(root);
+    pendingNodes = 1;
+    if (opts.ordered)
+        traversal.push_back(node);
+    tasks.push(0, std::move(node));
+
+    started = true;
+    for (int i = 0; i < opts.threadCount; ++i)
+        workers.emplace_back(&DLocalParallelWalker::workerLoop, this, i);
+
+    return true;
+}
+
+void DLocalParallelWalker::stop()
+{
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        stopped = true;
+    }
+    workCondition.notify_all();
+    spaceCondition.notify_all();
+    resultCondition.notify_all();
+
+    for (auto &worker : workers) {
+        if (worker.joinable())
+            worker.join();
+    }
+    workers.clear();
+}
+
+bool DLocalParallelWalker::isStopped() const
+{
+    return stopped;
+}
+
+int DLocalParallelWalker::lastErrno() const
+{
+    return error;
+}
+
+bool DLocalParallelWalker::nextBatch(DLocalParallelWalker::Batch *batch)
+{
+    if (!started || !batch)
+        return false;
+
+    if (opts.ordered)
+        return nextOrderedBatch(batch);
+
+    std::unique_lock<std::mutex> locker(lock);
+    resultCondition.wait(locker, [this]() {
+        return stopped || !results.empty() || pendingNodes == 0;
+    });
+    if (stopped || results.empty())
+        return false;
+
+    *batch = std::move(results.front());
+    results.pop_front();
+    spaceCondition.notify_one();
+    return true;
+}
+
+void DLocalParallelWalker::workerLoop(int worker)
+{
+    while (!stopped) {
+        NodePtr node;
+        if (tasks.take(worker, &node)) {
+            int expected = kPending;
+            // in ordered mode the consumer may have walked this node by itself
+            if (node->state.compare_exchange_strong(expected, kRunning))
+                processNode(node, worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> locker(lock);
+        workCondition.wait(locker, [this]() {
+            return stopped || tasks.size() > 0 || pendingNodes == 0;
+        });
+        if (pendingNodes == 0)
+            break;
+    }
+}
+
+void DLocalParallelWalker::processNode(const NodePtr &node, int worker)
+{
+    thread_local DLocalDirReader reader;
+
+    // like DEnumerator's single threaded walk, a subdirectory that can't be opened is listed but
+    // skipped, it doesn't fail the walk. the root was opened by start()
+    if (!reader.open(node->path.c_str()) || (opts.followSymlinks && !markVisited(reader.fd()))) {
+        reader.close();
+        finishNode(node);
+        return;
+    }
+
+    const std::string prefix = node->path == "/" ? node->path : node->path + "/";
+    Batch batch;
+    batch.dirPath = node->path;
+
+    DLocalDirReader::Entry entry;
+    while (!stopped && reader.next(&entry)) {
+        unsigned char type = entry.type;
+        struct statx st;
+        if (type == DT_UNKNOWN && reader.stat(entry, STATX_TYPE, false, &st))
+            type = DLocalDirReader::typeFromMode(st.stx_mode);
+
+        bool isDir = type == DT_DIR;
+        if (type == DT_LNK && opts.followSymlinks)
+            isDir = reader.stat(entry, STATX_TYPE, true, &st) && S_ISDIR(st.stx_mode);
+
+        batch.offsets.push_back(static_cast<uint32_t>(batch.names.size()));
+        batch.names.append(entry.name, entry.nameLength + 1);
+        batch.types.push_back(type);
+
+        if (isDir) {
+            NodePtr child = std::make_shared<Node>(prefix + entry.name);
+            // pushed under the lock, a worker checking tasks.size() before it waits can not miss it
+            std::lock_guard<std::mutex> locker(lock);
+            ++pendingNodes;
+            if (opts.ordered)
+                node->children.push_back(child);
+            tasks.push(worker, std::move(child));
+            workCondition.notify_one();
+        }
+
+        if (batch.size() >= opts.batchSize) {
+            publish(node, std::move(batch));
+            batch.clear();
+            batch.dirPath = node->path;
+        }
+    }
+
+    if (batch.size() > 0)
+        publish(node, std::move(batch));
+
+    if (reader.lastErrno() != 0) {
+        int expected = 0;
+        error.compare_exchange_strong(expected, reader.lastErrno());
+    }
+    reader.close();
+    finishNode(node);
+}
+
+void DLocalParallelWalker::publish(const NodePtr &node, DLocalParallelWalker::Batch &&batch)
+{
+    std::unique_lock<std::mutex> locker(lock);
+    if (opts.ordered) {
+        // never block the node the consumer is waiting for, otherwise all workers may wait on each other
+        spaceCondition.wait(locker, [this, &node]() {
+            return stopped || outstanding < opts.queueCapacity || node == frontier;
+        });
+        if (stopped)
+            return;
+        node->batches.push_back(std::move(batch));
+        ++outstanding;
+    } else {
+        spaceCondition.wait(locker, [this]() {
+            return stopped || results.size() < opts.queueCapacity;
+        });
+        if (stopped)
+            return;
+        results.push_back(std::move(batch));
+    }
+    resultCondition.notify_one();
+}
+
+void DLocalParallelWalker::finishNode(const NodePtr &node)
+{
+    bool allDone = false;
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        node->state = kDone;
+        node->finished = true;
+        allDone = --pendingNodes == 0;
+    }
+    if (allDone)
+        workCondition.notify_all();
+    resultCondition.notify_one();
+}
+
+bool DLocalParallelWalker::markVisited(int dirFd)
+{
+    struct stat st;
+    if (fstat(dirFd, &st) != 0)
+        return true;
+
+    std::lock_guard<std::mutex> locker(visitedLock);
+    return visited.insert({ static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino) }).second;
+}
+
+bool DLocalParallelWalker::nextOrderedBatch(DLocalParallelWalker::Batch *batch)
+{
+    std::unique_lock<std::mutex> locker(lock);
+    while (!stopped) {
+        if (!frontier) {
+            if (traversal.empty())
+                return false;
+            frontier = std::move(traversal.back());
+            traversal.pop_back();
+            spaceCondition.notify_all();
+        }
+
+        NodePtr node = frontier;
+        if (!node->batches.empty()) {
+            *batch = std::move(node->batches.front());
+            node->batches.pop_front();
+            --outstanding;
+            spaceCondition.notify_all();
+            return true;
+        }
+
+        if (node->finished) {
+            for (auto it = node->children.rbegin(); it != node->children.rend(); ++it)
+                traversal.push_back(*it);
+            node->children.clear();
+            frontier.reset();
+            continue;
+        }
+
+        // nobody walks the node we are waiting for, walk it here
+        int expected = kPending;
+        if (node->state.compare_exchange_strong(expected, kRunning)) {
+            locker.unlock();
+            processNode(node, -1);
+            locker.lock();
+            continue;
+        }
+
+        resultCondition.wait(locker);
+    }
+
+    return false;
+}
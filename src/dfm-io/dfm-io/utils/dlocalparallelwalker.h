@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DLOCALPARALLELWALKER_H
+#define DLOCALPARALLELWALKER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include "utils/dworkstealingqueue.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+BEGIN_IO_NAMESPACE
+
+// walk a local directory tree recursively with several threads,
+// results are delivered to one consumer by batches through a bounded queue
+class DLocalParallelWalker
+{
+public:
+    struct Batch
+    {
+        std::string dirPath;   // the directory all entries belong to
+        std::string names;   // names separated by '\0'
+        std::vector<uint32_t> offsets;
+        std::vector<unsigned char> types;
+
+        size_t size() const { return offsets.size(); }
+        const char *name(size_t index) const { return names.data() + offsets[index]; }
+        void clear();
+    };
+
+    struct Options
+    {
+        int threadCount { 4 };
+        bool followSymlinks { false };
+        // ordered: every directory is delivered contiguously, parents before children and
+        // siblings in the order they were read. unordered: directories are delivered as they are finished
+        bool ordered { false };
+        size_t batchSize { 512 };   // entries per batch
+        size_t queueCapacity { 64 };   // batches buffered before the workers block
+    };
+
+    explicit DLocalParallelWalker(const std::string &rootPath, const Options &options);
+    ~DLocalParallelWalker();
+
+    DLocalParallelWalker(const DLocalParallelWalker &) = delete;
+    DLocalParallelWalker &operator=(const DLocalParallelWalker &) = delete;
+
+    bool start();
+    void stop();
+    bool isStopped() const;
+    // the first error reading a directory, subdirectories that can't be opened are skipped silently
+    int lastErrno() const;
+
+    // blocks until a batch is available, returns false when the walk is over or stopped
+    bool nextBatch(Batch *batch);
+
+private:
+    enum NodeState : int {
+        kPending = 0,
+        kRunning,
+        kDone,
+    };
+
+    struct Node
+    {
+        explicit Node(std::string path)
+            : path(std::move(path)) { }
+        std::string path;
+        std::atomic<int> state { kPending };
+        // ordered mode only, guarded by lock
+        bool finished { false };
+        std::deque<Batch> batches;
+        std::vector<std::shared_ptr<Node>> children;
+    };
+    using NodePtr = std::shared_ptr<Node>;
+
+    void workerLoop(int worker);
+    void processNode(const NodePtr &node, int worker);
+    void publish(const NodePtr &node, Batch &&batch);
+    void finishNode(const NodePtr &node);
+    bool markVisited(int dirFd);
+    bool nextOrderedBatch(Batch *batch);
+
+    std::string root;
+    Options opts;
+    DWorkStealingQueue<NodePtr> tasks;
+    std::vector<std::thread> workers;
+
+    mutable std::mutex lock;
+    std::condition_variable workCondition;   // workers wait for tasks
+    std::condition_variable spaceCondition;   // workers wait for the consumer
+    std::condition_variable resultCondition;   // the consumer waits for results
+    std::deque<Batch> results;   // unordered mode
+    size_t outstanding { 0 };   // ordered mode, batches not consumed yet
+    size_t pendingNodes { 0 };
+    std::vector<NodePtr> traversal;   // ordered mode, nodes waiting to be consumed
+    NodePtr frontier;   // ordered mode, the node the consumer is draining
+
+    std::mutex visitedLock;
+    std::set<std::pair<uint64_t, uint64_t>> visited;   // (dev, ino) of walked directories, only if following symlinks
+
+    std::atomic_bool stopped { false };
+    std::atomic_int error { 0 };
+    bool started { false };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DLOCALPARALLELWALKER_H
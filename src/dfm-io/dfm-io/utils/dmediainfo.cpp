@@ -6,19 +6,188 @@
 
 #include <MediaInfo/MediaInfo.h>
 
-#include <QTimer>
-#include <QQueue>
-#include <QMutex>
-#include <QPointer>
+#include <QThread>
 #include <QDebug>
 
+#include <gio/gio.h>
+#include <gio-unix-2.0/gio/gunixmounts.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
-static constexpr size_t kMediaInfoStateFinished { 10000 };   // read finished and no error
+BEGIN_IO_NAMESPACE
 
-Q_GLOBAL_STATIC(QQueue<QSharedPointer<MediaInfoLib::MediaInfo>>, queueDestoryMediaInfo)
+// one file to parse, shared by the DMediaInfo and the pool
+struct DMediaInfoJob
+{
+    QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo;
+    std::wstring fileName;
+    std::string mount;
+    DMediaInfo::FinishedCallback callback { nullptr };
+    std::atomic_bool canceled { false };
+    // held while the callback runs, recursive: the callback may stop its own read
+    std::recursive_mutex callbackLock;
+};
+
+// a few threads parse all media files, MediaInfo::Open blocks until the file is read,
+// so nothing is polled and no thread is created per file.
+// a running Open can not be interrupted, so one mount gets all threads but one: files of a dead
+// network mount block their threads, the others go on with the files of other mounts
+class DMediaInfoPool
+{
+public:
+    static DMediaInfoPool *instance()
+    {
+        // never destroyed: a worker may be blocked in a file of a dead network mount at exit
+        static DMediaInfoPool *pool = new DMediaInfoPool;
+        return pool;
+    }
+
+    void enqueue(const std::shared_ptr<DMediaInfoJob> &job, int priority)
+    {
+        {
+            std::lock_guard<std::mutex> locker(lock);
+            // same priority: first come first served
+            jobs.emplace(std::make_pair(priority, ++sequence), job);
+        }
+        condition.notify_all();
+    }
+
+    // the mount point of path, found in the mount table only, the file system is not touched
+    std::string mountOf(const QString &path)
+    {
+        const QByteArray &localPath = path.toLocal8Bit();
+        std::lock_guard<std::mutex> locker(mountLock);
+        if (mountPoints.empty() || g_unix_mounts_changed_since(mountStamp)) {
+            mountPoints.clear();
+            GList *entries = g_unix_mounts_get(&mountStamp);
+            for (GList *it = entries; it; it = it->next)
+                mountPoints.emplace_back(g_unix_mount_get_mount_path(static_cast<GUnixMountEntry *>(it->data)));
+            g_list_free_full(entries, reinterpret_cast<GDestroyNotify>(g_unix_mount_free));
+        }
+
+        std::string best("/");
+        for (const std::string &point : mountPoints) {
+            if (point.size() <= best.size() || !localPath.startsWith(point.c_str()))
+                continue;
+            if (static_cast<size_t>(localPath.size()) == point.size() || localPath.at(static_cast<int>(point.size())) == '/')
+                best = point;
+        }
+        return best;
+    }
+
+    // 由于当远程文件夹下存在大量图片文件时，析构mediainfo对象耗时会很长，造成文管卡
+    // 所以将对象交给工作线程释放
+    void release(QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo, const std::string &mount)
+    {
+        {
+            std::lock_guard<std::mutex> locker(lock);
+            releases.emplace_back(mount, std::move(mediaInfo));
+        }
+        condition.notify_all();
+    }
+
+private:
+    DMediaInfoPool()
+    {
+        const int count = qBound(2, QThread::idealThreadCount() / 2, 4);
+        mountLimit = count - 1;
+        for (int i = 0; i < count; ++i)
+            std::thread(&DMediaInfoPool::workerLoop, this).detach();
+    }
+
+    void workerLoop()
+    {
+        while (true) {
+            std::shared_ptr<DMediaInfoJob> job;
+            QSharedPointer<MediaInfoLib::MediaInfo> released;
+            std::string mount;
+            {
+                std::unique_lock<std::mutex> locker(lock);
+                condition.wait(locker, [&]() { return take(&job, &released, &mount); });
+                ++busyMounts[mount];
+            }
+
+            if (job)
+                finish(job.get(), run(job.get()));
+            // released, or the last reference of a canceled job, is freed here outside the lock
+            job.reset();
+            released.reset();
+
+            {
+                std::lock_guard<std::mutex> locker(lock);
+                if (--busyMounts[mount] == 0)
+                    busyMounts.erase(mount);
+            }
+            condition.notify_all();
+        }
+    }
+
+    // by lock. waiting reads come before the objects to free, work of a mount at its limit waits
+    bool take(std::shared_ptr<DMediaInfoJob> *job, QSharedPointer<MediaInfoLib::MediaInfo> *released, std::string *mount)
+    {
+        auto available = [this](const std::string &key) {
+            auto it = busyMounts.find(key);
+            return it == busyMounts.end() || it->second < mountLimit;
+        };
+
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            if (!it->second->canceled && !available(it->second->mount))
+                continue;
+            *job = std::move(it->second);
+            *mount = (*job)->mount;
+            jobs.erase(it);
+            return true;
+        }
+        for (auto it = releases.begin(); it != releases.end(); ++it) {
+            if (!available(it->first))
+                continue;
+            *mount = it->first;
+            *released = std::move(it->second);
+            releases.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+    // the result of MediaInfo::Open, false for a file it can not parse
+    bool run(DMediaInfoJob *job)
+    {
+        if (job->canceled)
+            return false;
+
+        job->mediaInfo->Option(__T("Width"), __T("Text"));
+        job->mediaInfo->Option(__T("Height"), __T("Text"));
+        job->mediaInfo->Option(__T("Duration"), __T("Text"));
+        return job->mediaInfo->Open(job->fileName) != 0;
+    }
+
+    void finish(DMediaInfoJob *job, bool opened)
+    {
+        std::lock_guard<std::recursive_mutex> locker(job->callbackLock);
+        if (!job->canceled && job->callback)
+            job->callback(opened);
+    }
+
+    std::mutex lock;
+    std::condition_variable condition;
+    std::map<std::pair<int, quint64>, std::shared_ptr<DMediaInfoJob>> jobs;   // (priority, sequence)
+    quint64 sequence { 0 };
+    std::deque<std::pair<std::string, QSharedPointer<MediaInfoLib::MediaInfo>>> releases;   // (mount, object)
+    std::map<std::string, int> busyMounts;   // threads working on files of a mount
+    int mountLimit { 1 };
+
+    std::mutex mountLock;
+    std::vector<std::string> mountPoints;
+    guint64 mountStamp { 0 };
+};
 
-BEGIN_IO_NAMESPACE
 class DMediaInfoPrivate : public QObject
 {
 public:
@@ -26,68 +195,42 @@ public:
         : q(qq)
     {
         this->fileName = fileName;
-        isStopState.store(false);
+        mount = DMediaInfoPool::instance()->mountOf(fileName);
         mediaInfo.reset(new MediaInfoLib::MediaInfo());
     }
 
     ~DMediaInfoPrivate()
     {
-        if (mediaInfo) {
-            // 由于当远程文件夹下存在大量图片文件时，析构mediainfo对象耗时会很长，造成文管卡
-            // 所以将对象添加到队列中，开启线程去释放对象
-            static QMutex lock;
-            {
-                QMutexLocker locker(&lock);
-                queueDestoryMediaInfo->enqueue(mediaInfo);
-            }
-
-            static bool isRunning = false;
-            if (!isRunning) {
-                isRunning = true;
-                std::thread thread(
-                        []() {
-                            while (!queueDestoryMediaInfo->isEmpty()) {
-                                QMutexLocker locker(&lock);
-                                queueDestoryMediaInfo->dequeue();
-                            }
-                            isRunning = false;
-                        });
-                thread.detach();
-            }
-        }
+        stop();
+        if (mediaInfo)
+            DMediaInfoPool::instance()->release(std::move(mediaInfo), mount);
     }
 
     /**
      * @brief bug-35165, 将构造时读取media信息的方式改为独立的方法
      * 以免造成构造对象时直接卡住
      */
-    void start()
+    void start(DMediaInfo::FinishedCallback callback, int priority)
     {
-        if (isStopState.load())
+        stop();
+
+        job = std::make_shared<DMediaInfoJob>();
+        job->mediaInfo = mediaInfo;
+        job->fileName = fileName.toStdWString();
+        job->mount = mount;
+        job->callback = callback;
+        DMediaInfoPool::instance()->enqueue(job, priority);
+    }
+
+    void stop()
+    {
+        if (!job)
             return;
 
-        mediaInfo->Option(__T("Thread"));
-        mediaInfo->Option(__T("Width"), __T("Text"));
-        mediaInfo->Option(__T("Height"), __T("Text"));
-        mediaInfo->Option(__T("Duration"), __T("Text"));
-        mediaInfo->Open(fileName.toStdWString());
-
-        QPointer<DMediaInfoPrivate> me = this;
-        std::thread thread([me]() {
-            while (1) {
-                if (!me)
-                    break;
-                if (me->isStopState.load())
-                    break;
-                if (me->mediaInfo->State_Get() == kMediaInfoStateFinished) {
-                    me->callback();
-                    break;
-                }
-                std::chrono::milliseconds dura(200);
-                std::this_thread::sleep_for(dura);
-            }
-        });
-        thread.detach();
+        // waits for a running callback, afterwards no callback can start
+        std::lock_guard<std::recursive_mutex> locker(job->callbackLock);
+        job->canceled = true;
+        job.reset();
     }
 
     QString value(const QString &key, MediaInfoLib::stream_t type)
@@ -98,10 +241,10 @@ public:
 
 public:
     QString fileName;
+    std::string mount;   // limits the pool threads blocked by one mount
     QSharedPointer<MediaInfoLib::MediaInfo> mediaInfo { nullptr };
     DMediaInfo *q { nullptr };
-    DMediaInfo::FinishedCallback callback = nullptr;
-    std::atomic_bool isStopState;
+    std::shared_ptr<DMediaInfoJob> job;
 };
 END_IO_NAMESPACE
 
@@ -120,16 +263,12 @@ QString DMediaInfo::value(const QString &key, DFileInfo::MediaType meidiaType /*
     return d->value(key, static_cast<MediaInfoLib::stream_t>(meidiaType));
 }
 
-void DMediaInfo::startReadInfo(FinishedCallback callback)
+void DMediaInfo::startReadInfo(FinishedCallback callback, int priority)
 {
-    d->isStopState.store(false);
-    d->callback = callback;
-    d->start();
+    d->start(callback, priority);
 }
 
 void DMediaInfo::stopReadInfo()
 {
-    d->isStopState.store(true);
-    if (d->mediaInfo)
-        d->mediaInfo->Close();
+    d->stop();
 }
@@ -20,14 +20,18 @@ class DMediaInfoPrivate;
 class DMediaInfo : public QObject
 {
 public:
-    using FinishedCallback = std::function<void()>;
+    // opened is false if MediaInfo could not parse the file, its values are all empty then
+    using FinishedCallback = std::function<void(bool opened)>;
 
     explicit DMediaInfo(const QString &fileName);
     ~DMediaInfo();
 
     QString value(const QString &key, DFileInfo::MediaType meidiaType = DFileInfo::MediaType::kGeneral);
 
-    void startReadInfo(FinishedCallback callback);
+    // read by a shared worker pool, callback runs in a worker thread when the file is parsed.
+    // lower priority values are read first, like io priorities of gio
+    void startReadInfo(FinishedCallback callback, int priority = 0);
+    // callback is not called after this returns
     void stopReadInfo();
 
 private:
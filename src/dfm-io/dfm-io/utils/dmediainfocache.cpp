@@ -0,0 +1,267 @@
+// SPDX-FileCopyrightText: 2022 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dmediainfocache.h"
+
+#include <QDebug>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include <sys/mman.h>
+#include <sys/sysmacros.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+
+static constexpr quint32 kMagic { 0x43494d44 };   // "DMIC"
+static constexpr quint32 kVersion { 1 };
+static constexpr quint32 kSlotCount { 16384 };   // 2 MiB
+static constexpr quint32 kWays { 8 };
+
+BEGIN_IO_NAMESPACE
+
+struct DMediaInfoCache::Header
+{
+    quint32 magic;
+    quint32 version;
+    quint32 slotCount;
+    quint32 reserved;
+    quint64 clock;   // for lastUsed, not exact when several processes tick it
+    char padding[40];
+};
+
+struct DMediaInfoCache::Slot
+{
+    quint64 dev;
+    quint64 inode;
+    qint64 mtimeSec;
+    quint64 size;
+    quint32 mtimeNsec;
+    quint32 checksum;   // of everything but checksum and lastUsed
+    quint64 lastUsed;
+    quint8 mediaType;
+    quint8 used;
+    quint8 padding[6];
+    char duration[32];   // utf-8, '\0' terminated
+    char width[16];
+    char height[16];
+};
+
+END_IO_NAMESPACE
+
+USING_IO_NAMESPACE
+
+static quint64 devOf(const struct statx &st)
+{
+    return static_cast<quint64>(makedev(st.stx_dev_major, st.stx_dev_minor));
+}
+
+template<typename Slot>
+static quint32 checksumOf(const Slot &slot)
+{
+    Slot copy = slot;
+    copy.checksum = 0;
+    copy.lastUsed = 0;
+    // FNV-1a
+    quint32 hash = 2166136261u;
+    const auto *bytes = reinterpret_cast<const unsigned char *>(&copy);
+    for (size_t i = 0; i < sizeof(copy); ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<size_t N>
+static bool copyString(char (&dest)[N], const QString &value)
+{
+    const QByteArray &bytes = value.toUtf8();
+    if (bytes.size() >= static_cast<int>(N))
+        return false;
+    memset(dest, 0, N);
+    memcpy(dest, bytes.constData(), static_cast<size_t>(bytes.size()));
+    return true;
+}
+
+template<size_t N>
+static QString readString(const char (&src)[N])
+{
+    return QString::fromUtf8(src, static_cast<int>(strnlen(src, N)));
+}
+
+DMediaInfoCache *DMediaInfoCache::instance()
+{
+    static DMediaInfoCache cache;
+    return &cache;
+}
+
+DMediaInfoCache::DMediaInfoCache()
+{
+    if (!open())
+        qWarning() << "media info cache is not available";
+}
+
+DMediaInfoCache::~DMediaInfoCache()
+{
+    if (mapped)
+        munmap(mapped, mappedSize);
+    if (fd >= 0)
+        ::close(fd);
+}
+
+bool DMediaInfoCache::open()
+{
+    static_assert(sizeof(Header) == 64, "the file format changed, bump kVersion");
+    static_assert(sizeof(Slot) == 120, "the file format changed, bump kVersion");
+
+    g_autofree gchar *dir = g_build_filename(g_get_user_cache_dir(), "deepin", "dfm-io", nullptr);
+    if (g_mkdir_with_parents(dir, 0700) != 0)
+        return false;
+    // other processes may have the file mapped, it is never truncated: a new format is a new file
+    g_autofree gchar *name = g_strdup_printf("media-info-%u.cache", kVersion);
+    g_autofree gchar *path = g_build_filename(dir, name, nullptr);
+    mappedSize = sizeof(Header) + sizeof(Slot) * kSlotCount;
+
+    fd = ::open(path, O_RDWR | O_CLOEXEC);
+    if (fd >= 0 && mapFile())
+        return true;
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return createFile(dir, path);
+}
+
+bool DMediaInfoCache::mapFile()
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != mappedSize)
+        return false;
+
+    void *addr = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        return false;
+
+    const Header *fileHeader = static_cast<const Header *>(addr);
+    if (fileHeader->magic != kMagic || fileHeader->version != kVersion || fileHeader->slotCount != kSlotCount) {
+        munmap(addr, mappedSize);
+        return false;
+    }
+
+    mapped = addr;
+    header = static_cast<Header *>(mapped);
+    slots = reinterpret_cast<Slot *>(static_cast<char *>(mapped) + sizeof(Header));
+    return true;
+}
+
+bool DMediaInfoCache::createFile(const char *dir, const char *path)
+{
+    // set up under a temporary name and renamed over path, nobody ever sees a partial file.
+    // processes still mapping a replaced file keep their own copy until they exit
+    g_autofree gchar *tmpPath = g_build_filename(dir, "media-info.XXXXXX", nullptr);
+    fd = g_mkstemp_full(tmpPath, O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    bool ok = ftruncate(fd, static_cast<off_t>(mappedSize)) == 0;
+    void *addr = ok ? mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (addr != MAP_FAILED) {
+        // a new file reads as zeros, only the header is written
+        Header *fileHeader = static_cast<Header *>(addr);
+        fileHeader->magic = kMagic;
+        fileHeader->version = kVersion;
+        fileHeader->slotCount = kSlotCount;
+        ok = ::rename(tmpPath, path) == 0;
+    } else {
+        ok = false;
+    }
+
+    if (!ok) {
+        if (addr != MAP_FAILED)
+            munmap(addr, mappedSize);
+        ::unlink(tmpPath);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    mapped = addr;
+    header = static_cast<Header *>(mapped);
+    slots = reinterpret_cast<Slot *>(static_cast<char *>(mapped) + sizeof(Header));
+    return true;
+}
+
+DMediaInfoCache::Slot *DMediaInfoCache::setOf(const struct statx &st) const
+{
+    const quint64 hash = (devOf(st) * 0x9e3779b97f4a7c15ULL) ^ (st.stx_ino * 0xff51afd7ed558ccdULL);
+    return slots + (hash % (kSlotCount / kWays)) * kWays;
+}
+
+bool DMediaInfoCache::lookup(const struct statx &st, DFileInfo::MediaType type, Values *values)
+{
+    if (!slots)
+        return false;
+
+    Slot *set = setOf(st);
+    for (quint32 i = 0; i < kWays; ++i) {
+        // another process may write the slot meanwhile, only the copy is checked and read
+        Slot slot;
+        memcpy(&slot, &set[i], sizeof(Slot));
+        if (!slot.used || slot.dev != devOf(st) || slot.inode != st.stx_ino || slot.mediaType != static_cast<quint8>(type))
+            continue;
+        if (slot.checksum != checksumOf(slot))
+            return false;
+        if (slot.mtimeSec != st.stx_mtime.tv_sec || slot.mtimeNsec != st.stx_mtime.tv_nsec || slot.size != st.stx_size)
+            return false;
+
+        values->duration = readString(slot.duration);
+        values->width = readString(slot.width);
+        values->height = readString(slot.height);
+        set[i].lastUsed = ++header->clock;
+        return true;
+    }
+    return false;
+}
+
+void DMediaInfoCache::insert(const struct statx &st, DFileInfo::MediaType type, const Values &values)
+{
+    if (!slots)
+        return;
+    // nothing read, a hit would hide the values once the file can be parsed
+    if (values.duration.isEmpty() && values.width.isEmpty() && values.height.isEmpty())
+        return;
+
+    Slot slot;
+    memset(&slot, 0, sizeof(Slot));
+    slot.dev = devOf(st);
+    slot.inode = st.stx_ino;
+    slot.mtimeSec = st.stx_mtime.tv_sec;
+    slot.mtimeNsec = st.stx_mtime.tv_nsec;
+    slot.size = st.stx_size;
+    slot.mediaType = static_cast<quint8>(type);
+    slot.used = 1;
+    // values that do not fit are not cached, they are read again next time
+    if (!copyString(slot.duration, values.duration) || !copyString(slot.width, values.width)
+        || !copyString(slot.height, values.height))
+        return;
+    slot.checksum = checksumOf(slot);
+
+    std::lock_guard<std::mutex> locker(lock);
+    Slot *set = setOf(st);
+    Slot *target = nullptr;
+    for (quint32 i = 0; i < kWays; ++i) {
+        Slot &candidate = set[i];
+        if (candidate.used && candidate.dev == slot.dev && candidate.inode == slot.inode && candidate.mediaType == slot.mediaType) {
+            target = &candidate;
+            break;
+        }
+        if (!target || !candidate.used || (target->used && candidate.lastUsed < target->lastUsed))
+            target = &candidate;
+    }
+
+    slot.lastUsed = ++header->clock;
+    memcpy(target, &slot, sizeof(Slot));
+}
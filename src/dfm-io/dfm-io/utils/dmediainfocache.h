@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2022 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DMEDIAINFOCACHE_H
+#define DMEDIAINFOCACHE_H
+
+#include <dfm-io/dfmio_global.h>
+#include <dfm-io/dfileinfo.h>
+
+#include <QString>
+
+#include <mutex>
+
+#include <sys/stat.h>
+
+BEGIN_IO_NAMESPACE
+
+// duration, width and height read by DMediaInfo, kept across runs in a memory mapped file of the user
+// cache dir. an entry is valid while (dev, inode, mtime, size) of the file are unchanged. the file has a
+// fixed number of slots in sets of 8, a full set drops its least recently used entry.
+// several processes share the file, a torn entry fails its checksum and counts as missing.
+// the file is never truncated, a process mapping it would get SIGBUS
+class DMediaInfoCache
+{
+public:
+    struct Values
+    {
+        QString duration;
+        QString width;
+        QString height;
+    };
+
+    static DMediaInfoCache *instance();
+
+    bool lookup(const struct statx &st, DFileInfo::MediaType type, Values *values);
+    // values that are all empty are not cached
+    void insert(const struct statx &st, DFileInfo::MediaType type, const Values &values);
+
+private:
+    struct Header;
+    struct Slot;
+
+    DMediaInfoCache();
+    ~DMediaInfoCache();
+    bool open();
+    // fd is an existing file of this format
+    bool mapFile();
+    // a new file replaces whatever is at path
+    bool createFile(const char *dir, const char *path);
+    Slot *setOf(const struct statx &st) const;
+
+    std::mutex lock;   // writers of this process
+    int fd { -1 };
+    void *mapped { nullptr };
+    size_t mappedSize { 0 };
+    Header *header { nullptr };
+    Slot *slots { nullptr };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DMEDIAINFOCACHE_H
@@ -0,0 +1,245 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dnamematcher.h"
+
+#include <QString>
+#include <QVarLengthArray>
+
+USING_IO_NAMESPACE
+
+static bool hasWildcard(const QByteArray &pattern, int from, int to)
+{
+    for (int i = from; i < to; ++i) {
+        const char c = pattern.at(i);
+        if (c == '*' || c == '?' || c == '[')
+            return true;
+    }
+    return false;
+}
+
+static void addLength(QList<int> &lengths, int length)
+{
+    if (!lengths.contains(length))
+        lengths.append(length);
+}
+
+// decode one utf-8 code point, invalid bytes are taken as one code point each
+static uint32_t decodeUtf8(const char *s, size_t length, size_t *consumed)
+{
+    const auto c = static_cast<unsigned char>(s[0]);
+    size_t count = 1;
+    uint32_t value = c;
+    if (c >= 0xF0 && c < 0xF8) {
+        count = 4;
+        value = c & 0x07;
+    } else if (c >= 0xE0) {
+        count = c < 0xF0 ? 3 : 1;
+        value = c & 0x0F;
+    } else if (c >= 0xC0) {
+        count = 2;
+        value = c & 0x1F;
+    }
+
+    if (count == 1 || count > length) {
+        *consumed = 1;
+        return c;
+    }
+
+    for (size_t i = 1; i < count; ++i) {
+        const auto next = static_cast<unsigned char>(s[i]);
+        if ((next & 0xC0) != 0x80) {
+            *consumed = 1;
+            return c;
+        }
+        value = (value << 6) | (next & 0x3F);
+    }
+    *consumed = count;
+    return value;
+}
+
+// match "[...]" at pattern[*p] against one code point of name[*n], returns false if the class is malformed
+static bool matchClass(const char *pattern, size_t patternLength, size_t *p,
+                       const char *name, size_t length, size_t *n, bool *matched)
+{
+    size_t pos = *p + 1;
+    bool negate = false;
+    if (pos < patternLength && (pattern[pos] == '!' || pattern[pos] == '^')) {
+        negate = true;
+        ++pos;
+    }
+
+    size_t consumed = 0;
+    const uint32_t ch = decodeUtf8(name + *n, length - *n, &consumed);
+    bool found = false;
+    bool first = true;
+    while (pos < patternLength && (pattern[pos] != ']' || first)) {
+        first = false;
+        size_t step = 0;
+        const uint32_t low = decodeUtf8(pattern + pos, patternLength - pos, &step);
+        pos += step;
+        uint32_t high = low;
+        if (pos + 1 < patternLength && pattern[pos] == '-' && pattern[pos + 1] != ']') {
+            high = decodeUtf8(pattern + pos + 1, patternLength - pos - 1, &step);
+            pos += 1 + step;
+        }
+        if (ch >= low && ch <= high)
+            found = true;
+    }
+
+    if (pos >= patternLength)
+        return false;
+
+    *p = pos + 1;
+    *n += consumed;
+    *matched = found != negate;
+    return true;
+}
+
+void DNameMatcher::compile(const QStringList &patterns, bool caseSensitive)
+{
+    clear();
+    this->caseSensitive = caseSensitive;
+
+    for (const QString &pattern : patterns) {
+        if (pattern.isEmpty())
+            continue;
+
+        empty = false;
+        const QByteArray &bytes = (caseSensitive ? pattern : pattern.toCaseFolded()).toUtf8();
+        const int length = bytes.length();
+        if (bytes == "*") {
+            matchAll = true;
+        } else if (!hasWildcard(bytes, 0, length)) {
+            exacts.insert(bytes);
+        } else if (bytes.startsWith('*') && !hasWildcard(bytes, 1, length)) {
+            suffixes.insert(bytes.mid(1));
+            addLength(suffixLengths, length - 1);
+        } else if (bytes.endsWith('*') && !hasWildcard(bytes, 0, length - 1)) {
+            prefixes.insert(bytes.left(length - 1));
+            addLength(prefixLengths, length - 1);
+        } else {
+            globs.append(bytes);
+        }
+    }
+}
+
+void DNameMatcher::clear()
+{
+    empty = true;
+    matchAll = false;
+    exacts.clear();
+    suffixes.clear();
+    suffixLengths.clear();
+    prefixes.clear();
+    prefixLengths.clear();
+    globs.clear();
+}
+
+bool DNameMatcher::matches(const char *name, size_t length) const
+{
+    if (matchAll)
+        return true;
+
+    if (caseSensitive)
+        return matchesFolded(name, length);
+
+    // ascii names are folded in place, only the others go through QString
+    QVarLengthArray<char, 256> folded(static_cast<int>(length));
+    for (size_t i = 0; i < length; ++i) {
+        const char c = name[i];
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            const QByteArray &bytes = QString::fromUtf8(name, static_cast<int>(length)).toCaseFolded().toUtf8();
+            return matchesFolded(bytes.constData(), static_cast<size_t>(bytes.length()));
+        }
+        folded[static_cast<int>(i)] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+    return matchesFolded(folded.constData(), length);
+}
+
+bool DNameMatcher::matchesFolded(const char *name, size_t length) const
+{
+    const int size = static_cast<int>(length);
+    if (!exacts.isEmpty() && exacts.contains(QByteArray::fromRawData(name, size)))
+        return true;
+
+    for (int suffixLength : suffixLengths) {
+        if (suffixLength <= size && suffixes.contains(QByteArray::fromRawData(name + size - suffixLength, suffixLength)))
+            return true;
+    }
+
+    for (int prefixLength : prefixLengths) {
+        if (prefixLength <= size && prefixes.contains(QByteArray::fromRawData(name, prefixLength)))
+            return true;
+    }
+
+    for (const QByteArray &glob : globs) {
+        if (globMatch(glob.constData(), static_cast<size_t>(glob.length()), name, length))
+            return true;
+    }
+
+    return false;
+}
+
+bool DNameMatcher::globMatch(const char *pattern, size_t patternLength, const char *name, size_t length)
+{
+    constexpr size_t kNoStar = static_cast<size_t>(-1);
+    size_t p = 0;
+    size_t n = 0;
+    size_t starP = kNoStar;
+    size_t starN = 0;
+
+    // one '*' is enough to backtrack to, a later '*' replaces it
+    while (n < length) {
+        if (p < patternLength) {
+            const char c = pattern[p];
+            if (c == '*') {
+                starP = ++p;
+                starN = n;
+                continue;
+            }
+            if (c == '?') {
+                size_t consumed = 0;
+                decodeUtf8(name + n, length - n, &consumed);
+                n += consumed;
+                ++p;
+                continue;
+            }
+            if (c == '[') {
+                bool matched = false;
+                size_t nextP = p;
+                size_t nextN = n;
+                if (matchClass(pattern, patternLength, &nextP, name, length, &nextN, &matched)) {
+                    if (matched) {
+                        p = nextP;
+                        n = nextN;
+                        continue;
+                    }
+                } else if (name[n] == '[') {
+                    // no closing ']', '[' is a normal character
+                    ++p;
+                    ++n;
+                    continue;
+                }
+            } else if (c == name[n]) {
+                ++p;
+                ++n;
+                continue;
+            }
+        }
+
+        if (starP == kNoStar)
+            return false;
+
+        size_t consumed = 0;
+        decodeUtf8(name + starN, length - starN, &consumed);
+        starN += consumed;
+        n = starN;
+        p = starP;
+    }
+
+    while (p < patternLength && pattern[p] == '*')
+        ++p;
+    return p == patternLength;
+}
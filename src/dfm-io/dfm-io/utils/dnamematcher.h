@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DNAMEMATCHER_H
+#define DNAMEMATCHER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+
+BEGIN_IO_NAMESPACE
+
+// wildcard name filters ('*', '?' and '[...]', like QDir::setNameFilters) compiled once.
+// "name" and "*.ext"/"prefix*" patterns are answered by hash lookups,
+// only patterns with other wildcards are run by the glob matcher
+class DNameMatcher
+{
+public:
+    void compile(const QStringList &patterns, bool caseSensitive);
+    void clear();
+
+    bool isEmpty() const { return empty; }
+    // name is utf-8, returns true if any pattern matches
+    bool matches(const char *name, size_t length) const;
+
+    static bool globMatch(const char *pattern, size_t patternLength, const char *name, size_t length);
+
+private:
+    bool matchesFolded(const char *name, size_t length) const;
+
+    bool empty { true };
+    bool caseSensitive { false };
+    bool matchAll { false };   // "*" is one of the patterns
+    QSet<QByteArray> exacts;
+    QSet<QByteArray> suffixes;   // "*.jpg" is stored as ".jpg"
+    QList<int> suffixLengths;
+    QSet<QByteArray> prefixes;   // "IMG_*" is stored as "IMG_"
+    QList<int> prefixLengths;
+    QList<QByteArray> globs;
+};
+
+END_IO_NAMESPACE
+
+#endif   // DNAMEMATCHER_H
@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dsortkeybuilder.h"
+
+#include <QCollator>
+#include <QVector>
+
+#include <algorithm>
+
+USING_IO_NAMESPACE
+
+// a key is a list of elements, each starts with its class, the class order is the order of compareByString
+enum KeyClass : char {
+    kEnd = 0x00,   // end of the base name, sorts shorter names first
+    kNumber = 0x01,   // 2 bytes count of significant digits + the digits
+    kLetter = 0x02,   // lower case ascii letter
+    kHan = 0x03,   // 3 bytes collation rank
+    kSymbol = 0x04,   // 3 bytes code point
+};
+
+// 汉字 not given to addName() sort after the known ones
+static constexpr uint kUnknownHanRank { 0x800000 };
+
+static uint codePointAt(const QString &str, int *pos)
+{
+    const QChar ch = str.at(*pos);
+    ++*pos;
+    if (ch.isHighSurrogate() && *pos < str.length() && str.at(*pos).isLowSurrogate())
+        return QChar::surrogateToUcs4(ch, str.at((*pos)++));
+    return ch.unicode();
+}
+
+static bool isDigit(ushort ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+static bool isLetter(ushort ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+static bool isHan(uint ucs4)
+{
+    return QChar::script(ucs4) == QChar::Script_Han;
+}
+
+static QString fromCodePoint(uint ucs4)
+{
+    if (QChar::requiresSurrogates(ucs4))
+        return QString { QChar(QChar::highSurrogate(ucs4)), QChar(QChar::lowSurrogate(ucs4)) };
+    return QString(QChar(ucs4));
+}
+
+static int baseLength(const QString &name)
+{
+    const int dot = name.lastIndexOf('.');
+    return dot < 0 ? name.length() : dot;
+}
+
+static void appendCode(QByteArray &key, char keyClass, uint value)
+{
+    key.append(keyClass);
+    key.append(static_cast<char>((value >> 16) & 0xFF));
+    key.append(static_cast<char>((value >> 8) & 0xFF));
+    key.append(static_cast<char>(value & 0xFF));
+}
+
+void DSortKeyBuilder::addName(const QString &name)
+{
+    const int base = baseLength(name);
+    int pos = 0;
+    while (pos < base) {
+        if (name.at(pos).unicode() < 0x80) {
+            ++pos;
+            continue;
+        }
+        const uint ucs4 = codePointAt(name, &pos);
+        if (isHan(ucs4) && !hanRanks.contains(ucs4))
+            hanRanks.insert(ucs4, 0);
+    }
+    prepared = false;
+}
+
+void DSortKeyBuilder::prepare()
+{
+    if (prepared)
+        return;
+
+    QVector<uint> chars;
+    chars.reserve(hanRanks.size());
+    for (auto it = hanRanks.cbegin(); it != hanRanks.cend(); ++it)
+        chars.append(it.key());
+
+    // same collator as compareByStringEx, but every pair of 汉字 is compared once per listing at most
+    QCollator collator;
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    std::sort(chars.begin(), chars.end(), [&collator](uint left, uint right) {
+        const int ret = collator.compare(fromCodePoint(left), fromCodePoint(right));
+        return ret == 0 ? left < right : ret < 0;
+    });
+
+    for (int i = 0; i < chars.size(); ++i)
+        hanRanks[chars.at(i)] = static_cast<uint>(i + 1);
+    prepared = true;
+}
+
+QByteArray DSortKeyBuilder::key(const QString &name) const
+{
+    QByteArray key;
+    key.reserve(name.length() * 2 + 16);
+
+    const int base = baseLength(name);
+    int pos = 0;
+    while (pos < base) {
+        const ushort ch = name.at(pos).unicode();
+        if (isDigit(ch)) {
+            // leading zeros are not significant, a longer number is a bigger number
+            int start = pos;
+            while (pos < base && isDigit(name.at(pos).unicode()))
+                ++pos;
+            while (start < pos - 1 && name.at(start).unicode() == '0')
+                ++start;
+            const int digits = qMin(pos - start, 0xFFFF);
+            key.append(kNumber);
+            key.append(static_cast<char>(digits >> 8));
+            key.append(static_cast<char>(digits & 0xFF));
+            for (int i = start; i < start + digits; ++i)
+                key.append(static_cast<char>(name.at(i).unicode()));
+            continue;
+        }
+
+        if (isLetter(ch)) {
+            key.append(kLetter);
+            key.append(static_cast<char>(ch | 0x20));
+            ++pos;
+            continue;
+        }
+
+        const uint ucs4 = codePointAt(name, &pos);
+        if (isHan(ucs4))
+            appendCode(key, kHan, hanRanks.value(ucs4, kUnknownHanRank | ucs4));
+        else
+            appendCode(key, kSymbol, ucs4);
+    }
+    key.append(kEnd);
+
+    // 基本名相同时按后缀排序，compareByStringEx 把没有 '.' 的名称整体当作后缀，
+    // 所以 "abc.aaa" 排在 "abc" 之前，"abc." 的空后缀排在最前
+    key.append((base < name.length() ? name.mid(base + 1) : name).toUtf8());
+    key.append(kEnd);
+
+    // names only different in case or leading zeros still get a stable order
+    key.append(name.toUtf8());
+    return key;
+}
@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DSORTKEYBUILDER_H
+#define DSORTKEYBUILDER_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+BEGIN_IO_NAMESPACE
+
+// byte string keys for the file name order of DLocalHelper::compareByString, comparing two keys by
+// memcmp (QByteArray::operator<) gives the name order: numbers (by value) → letters (a A b B) → 汉字 (by
+// collation) → other characters, then the shorter base name, then the suffix. like compareByString, a name
+// without '.' is its own suffix, so "abc.aaa" sorts before "abc".
+// 汉字 are collated once per distinct character: add every name first, then prepare(), then key()
+class DSortKeyBuilder
+{
+public:
+    void addName(const QString &name);
+    void prepare();
+    QByteArray key(const QString &name) const;
+
+private:
+    QHash<uint, uint> hanRanks;   // code point -> rank in the collation order, filled by addName() with 0
+    bool prepared { false };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DSORTKEYBUILDER_H
@@ -0,0 +1,390 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "duringengine.h"
+
+#include <QDebug>
+
+#include <glib.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#endif
+
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#    define DFM_IO_HAS_URING 1
+#endif
+
+BEGIN_IO_NAMESPACE
+
+#ifdef DFM_IO_HAS_URING
+
+static constexpr unsigned kRingEntries { 256 };
+static constexpr int kFixedBufferCount { 16 };   // 2 MiB of locked memory
+
+class DUringEnginePrivate;
+
+struct DUringRequest
+{
+    DUringEnginePrivate *engine { nullptr };
+    quint8 opcode { IORING_OP_NOP };
+    int fd { -1 };
+    char *buffer { nullptr };
+    size_t length { 0 };
+    quint64 offset { 0 };
+    int fixedIndex { -1 };
+    std::unique_ptr<char[]> ownBuffer;   // readFixed() when all registered buffers are in use
+    qint64 result { 0 };
+    DUringEngine::Completion done;
+};
+
+class DUringEnginePrivate
+{
+public:
+    ~DUringEnginePrivate()
+    {
+        if (sqRing && sqRing != MAP_FAILED)
+            munmap(sqRing, sqRingSize);
+        if (cqRing && cqRing != MAP_FAILED && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if (sqes && sqes != MAP_FAILED)
+            munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+        if (ringFd >= 0)
+            ::close(ringFd);
+    }
+
+    bool setup()
+    {
+        memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, kRingEntries, &params));
+        if (ringFd < 0)
+            return false;
+        // IORING_OP_READ and IORING_OP_WRITE came with 5.6, together with this flag
+        if (!(params.features & IORING_FEAT_RW_CUR_POS))
+            return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(quint32);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap)
+            sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED)
+            return false;
+        cqRing = singleMap ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+            return false;
+        sqes = static_cast<io_uring_sqe *>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED)
+            return false;
+
+        char *sq = static_cast<char *>(sqRing);
+        sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        char *cq = static_cast<char *>(cqRing);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        // a request holds an sq entry until the kernel takes it and a cq entry until it is reaped
+        maxInFlight = qMin(params.sq_entries, params.cq_entries);
+
+        registerBuffers();
+        std::thread(&DUringEnginePrivate::reapLoop, this).detach();
+        return true;
+    }
+
+    // without registered buffers readFixed() reads into buffers of its own
+    void registerBuffers()
+    {
+        fixedBuffers.reset(new char[kFixedBufferCount * DUringEngine::kFixedBufferSize]);
+        std::vector<iovec> iovecs(kFixedBufferCount);
+        for (int i = 0; i < kFixedBufferCount; ++i) {
+            iovecs[static_cast<size_t>(i)].iov_base = fixedBuffers.get() + i * DUringEngine::kFixedBufferSize;
+            iovecs[static_cast<size_t>(i)].iov_len = DUringEngine::kFixedBufferSize;
+        }
+        if (::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), kFixedBufferCount) != 0) {
+            qInfo() << "io_uring buffers are not registered:" << strerror(errno);
+            fixedBuffers.reset();
+            return;
+        }
+        for (int i = 0; i < kFixedBufferCount; ++i)
+            freeFixed.push_back(i);
+    }
+
+    void submit(DUringRequest *request)
+    {
+        request->engine = this;
+
+        std::lock_guard<std::mutex> locker(lock);
+        if (inFlight >= maxInFlight) {
+            pending.push_back(request);
+            return;
+        }
+        push(request);
+        ++inFlight;
+    }
+
+    // by lock
+    void push(DUringRequest *request)
+    {
+        const unsigned tail = *sqTail;
+        io_uring_sqe *sqe = &sqes[tail & sqMask];
+        memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode = request->opcode;
+        sqe->fd = request->fd;
+        sqe->addr = reinterpret_cast<quint64>(request->buffer);
+        // the kernel transfers at most about 2 GiB per call anyway, the rest is a short read or write
+        sqe->len = static_cast<quint32>(qMin<size_t>(request->length, 0x7ffff000));
+        sqe->off = request->offset;
+        if (request->fixedIndex >= 0)
+            sqe->buf_index = static_cast<quint16>(request->fixedIndex);
+        sqe->user_data = reinterpret_cast<quint64>(request);
+        sqArray[tail & sqMask] = tail & sqMask;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        // entries left by a failed enter before are submitted together with this one
+        const unsigned count = tail + 1 - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        int ret = 0;
+        do {
+            ret = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, count, 0, 0, nullptr, 0));
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0)
+            qWarning() << "io_uring_enter failed:" << strerror(errno);
+    }
+
+    void reapLoop()
+    {
+        std::vector<DUringRequest *> completed;
+        while (true) {
+            const int ret = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                qWarning() << "io_uring reaping stopped:" << strerror(errno);
+                return;
+            }
+
+            unsigned head = *cqHead;
+            const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            for (; head != tail; ++head) {
+                const io_uring_cqe &cqe = cqes[head & cqMask];
+                DUringRequest *request = reinterpret_cast<DUringRequest *>(cqe.user_data);
+                request->result = cqe.res;
+                completed.push_back(request);
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+            if (completed.empty())
+                continue;
+
+            {
+                std::lock_guard<std::mutex> locker(lock);
+                inFlight -= static_cast<unsigned>(completed.size());
+                while (!pending.empty() && inFlight < maxInFlight) {
+                    push(pending.front());
+                    pending.pop_front();
+                    ++inFlight;
+                }
+            }
+
+            for (DUringRequest *request : completed) {
+                if (request->done)
+                    request->done(request->result, request->buffer);
+                if (request->fixedIndex >= 0)
+                    releaseFixed(request->fixedIndex);
+                delete request;
+            }
+            completed.clear();
+        }
+    }
+
+    int acquireFixed()
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        if (freeFixed.empty())
+            return -1;
+        const int index = freeFixed.back();
+        freeFixed.pop_back();
+        return index;
+    }
+
+    void releaseFixed(int index)
+    {
+        std::lock_guard<std::mutex> locker(lock);
+        freeFixed.push_back(index);
+    }
+
+public:
+    io_uring_params params;
+    int ringFd { -1 };
+    void *sqRing { nullptr };
+    void *cqRing { nullptr };
+    size_t sqRingSize { 0 };
+    size_t cqRingSize { 0 };
+    io_uring_sqe *sqes { nullptr };
+    unsigned *sqHead { nullptr };
+    unsigned *sqTail { nullptr };
+    unsigned sqMask { 0 };
+    unsigned *sqArray { nullptr };
+    unsigned *cqHead { nullptr };
+    unsigned *cqTail { nullptr };
+    unsigned cqMask { 0 };
+    io_uring_cqe *cqes { nullptr };
+
+    std::mutex lock;
+    unsigned inFlight { 0 };
+    unsigned maxInFlight { 0 };
+    std::deque<DUringRequest *> pending;   // submitted while the ring was full
+    std::unique_ptr<char[]> fixedBuffers;
+    std::vector<int> freeFixed;
+};
+
+#else   // DFM_IO_HAS_URING
+
+class DUringEnginePrivate
+{
+public:
+    bool setup() { return false; }
+};
+
+#endif   // DFM_IO_HAS_URING
+
+END_IO_NAMESPACE
+
+USING_IO_NAMESPACE
+
+DUringEngine *DUringEngine::instance()
+{
+    // never destroyed: the reaping thread may still wait in the kernel at exit
+    static DUringEngine *engine = []() -> DUringEngine * {
+        DUringEngine *created = new DUringEngine;
+        if (created->d->setup())
+            return created;
+        qInfo() << "io_uring is not available, file io stays on GIO";
+        delete created;
+        return nullptr;
+    }();
+    return engine;
+}
+
+static gboolean runPosted(gpointer userData)
+{
+    (*static_cast<std::function<void()> *>(userData))();
+    return G_SOURCE_REMOVE;
+}
+
+static void freePosted(gpointer userData)
+{
+    delete static_cast<std::function<void()> *>(userData);
+}
+
+void DUringEngine::post(GMainContext *context, std::function<void()> func)
+{
+    // an idle source and not g_main_context_invoke(), which runs func at once if the context can be acquired
+    GSource *source = g_idle_source_new();
+    g_source_set_priority(source, G_PRIORITY_DEFAULT);
+    g_source_set_callback(source, &runPosted, new std::function<void()>(std::move(func)), &freePosted);
+    g_source_attach(source, context);
+    g_source_unref(source);
+}
+
+DUringEngine::DUringEngine()
+    : d(new DUringEnginePrivate)
+{
+}
+
+DUringEngine::~DUringEngine()
+{
+    delete d;
+}
+
+bool DUringEngine::read(int fd, char *buffer, size_t length, qint64 offset, Completion done)
+{
+#ifdef DFM_IO_HAS_URING
+    DUringRequest *request = new DUringRequest;
+    request->opcode = IORING_OP_READ;
+    request->fd = fd;
+    request->buffer = buffer;
+    request->length = length;
+    request->offset = static_cast<quint64>(offset);
+    request->done = std::move(done);
+    d->submit(request);
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(buffer)
+    Q_UNUSED(length)
+    Q_UNUSED(offset)
+    Q_UNUSED(done)
+#endif
+    return false;
+}
+
+bool DUringEngine::write(int fd, const char *buffer, size_t length, qint64 offset, Completion done)
+{
+#ifdef DFM_IO_HAS_URING
+    DUringRequest *request = new DUringRequest;
+    request->opcode = IORING_OP_WRITE;
+    request->fd = fd;
+    request->buffer = const_cast<char *>(buffer);
+    request->length = length;
+    request->offset = static_cast<quint64>(offset);
+    request->done = std::move(done);
+    d->submit(request);
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(buffer)
+    Q_UNUSED(length)
+    Q_UNUSED(offset)
+    Q_UNUSED(done)
+#endif
+    return false;
+}
+
+bool DUringEngine::readFixed(int fd, size_t length, qint64 offset, Completion done)
+{
+#ifdef DFM_IO_HAS_URING
+    if (length > kFixedBufferSize)
+        return false;
+
+    DUringRequest *request = new DUringRequest;
+    request->fd = fd;
+    request->length = length;
+    request->offset = static_cast<quint64>(offset);
+    request->done = std::move(done);
+    request->fixedIndex = d->fixedBuffers ? d->acquireFixed() : -1;
+    if (request->fixedIndex >= 0) {
+        request->opcode = IORING_OP_READ_FIXED;
+        request->buffer = d->fixedBuffers.get() + static_cast<size_t>(request->fixedIndex) * kFixedBufferSize;
+    } else {
+        request->opcode = IORING_OP_READ;
+        request->ownBuffer.reset(new char[length]);
+        request->buffer = request->ownBuffer.get();
+    }
+    d->submit(request);
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(length)
+    Q_UNUSED(offset)
+    Q_UNUSED(done)
+#endif
+    return false;
+}
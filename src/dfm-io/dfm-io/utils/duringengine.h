@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DURINGENGINE_H
+#define DURINGENGINE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <QtGlobal>
+
+#include <glib.h>
+
+#include <functional>
+
+BEGIN_IO_NAMESPACE
+
+class DUringEnginePrivate;
+
+// reads and writes of local files by io_uring, one ring for the process and one thread reaping completions.
+// the ring is driven by raw syscalls, liburing is not needed.
+// completions run on the reaping thread and must not block, post() hands results to the thread of the caller
+class DUringEngine
+{
+public:
+    // bytes transferred or -errno, data is the read buffer, valid only during the call
+    using Completion = std::function<void(qint64 result, const char *data)>;
+
+    // runs func later in context, always from the main loop of context and never directly
+    static void post(GMainContext *context, std::function<void()> func);
+
+    // size of the registered buffers used by readFixed()
+    static constexpr size_t kFixedBufferSize = 128 * 1024;
+
+    // nullptr if the kernel has no usable io_uring
+    static DUringEngine *instance();
+
+    // buffer must stay valid until done is called. false if nothing was submitted
+    bool read(int fd, char *buffer, size_t length, qint64 offset, Completion done);
+    bool write(int fd, const char *buffer, size_t length, qint64 offset, Completion done);
+    // reads into a registered buffer of the engine, length at most kFixedBufferSize
+    bool readFixed(int fd, size_t length, qint64 offset, Completion done);
+
+private:
+    DUringEngine();
+    ~DUringEngine();
+    DUringEnginePrivate *d { nullptr };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DURINGENGINE_H
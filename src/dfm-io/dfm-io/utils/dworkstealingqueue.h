@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DWORKSTEALINGQUEUE_H
+#define DWORKSTEALINGQUEUE_H
+
+#include <dfm-io/dfmio_global.h>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+BEGIN_IO_NAMESPACE
+
+// one deque per worker, the owner works LIFO on the back (depth first, hot cache),
+// idle workers steal FIFO from the front (the biggest, oldest subtrees)
+template<typename T>
+class DWorkStealingQueue
+{
+public:
+    explicit DWorkStealingQueue(int workerCount)
+        : deques(static_cast<size_t>(workerCount < 1 ? 1 : workerCount))
+    {
+        for (auto &deque : deques)
+            deque.reset(new Deque);
+    }
+
+    int workerCount() const
+    {
+        return static_cast<int>(deques.size());
+    }
+
+    size_t size() const
+    {
+        return queued.load(std::memory_order_acquire);
+    }
+
+    void push(int worker, T &&task)
+    {
+        Deque &deque = *deques[index(worker)];
+        {
+            std::lock_guard<std::mutex> locker(deque.lock);
+            deque.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+    }
+
+    // pop own work first, then try to steal from the others
+    bool take(int worker, T *task)
+    {
+        if (queued.load(std::memory_order_acquire) == 0)
+            return false;
+
+        const size_t self = index(worker);
+        {
+            Deque &deque = *deques[self];
+            std::lock_guard<std::mutex> locker(deque.lock);
+            if (!deque.tasks.empty()) {
+                *task = std::move(deque.tasks.back());
+                deque.tasks.pop_back();
+                queued.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < deques.size(); ++i) {
+            Deque &victim = *deques[(self + i) % deques.size()];
+            std::lock_guard<std::mutex> locker(victim.lock);
+            if (!victim.tasks.empty()) {
+                *task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    struct Deque
+    {
+        std::mutex lock;
+        std::deque<T> tasks;
+    };
+
+    size_t index(int worker) const
+    {
+        return worker < 0 ? 0 : static_cast<size_t>(worker) % deques.size();
+    }
+
+    std::vector<std::unique_ptr<Deque>> deques;
+    std::atomic<size_t> queued { 0 };
+};
+
+END_IO_NAMESPACE
+
+#endif   // DWORKSTEALINGQUEUE_H
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dattributetable.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+USING_IO_NAMESPACE
+
+// the lookups are usable at compile time
+static_assert(DAttributeTable::ordinal(DFileInfo::AttributeID::kStandardType) == 0, "kStandardType is the first attribute");
+static_assert(DAttributeTable::ordinal(DFileInfo::AttributeID::kAttributeIDMax) == -1, "kAttributeIDMax has no descriptor");
+static_assert(DAttributeTable::descriptor(DFileInfo::AttributeID::kAttributeIDMax) == nullptr, "kAttributeIDMax has no descriptor");
+static_assert(DAttributeTable::type(DFileInfo::AttributeID::kStandardSize) == DFileInfo::DFileAttributeType::kTypeUInt64, "standard::size is read as uint64");
+static_assert(DAttributeTable::keyOf<DFileInfo::AttributeID::kStandardName>()[0] == 's', "keyOf() is resolved at compile time");
+
+/**
+ * @brief TEST ordinals are dense and follow the ids
+ */
+TEST(TestDAttributeTable, ordinals)
+{
+    for (int i = 0; i < kAttributeCount; ++i) {
+        const DAttributeDescriptor &desc = kAttributeDescriptors[i];
+        EXPECT_EQ(DAttributeTable::ordinal(desc.id), i) << desc.key;
+        EXPECT_EQ(DAttributeTable::descriptor(desc.id), &desc) << desc.key;
+        if (i > 0)
+            EXPECT_LT(kAttributeDescriptors[i - 1].id, desc.id) << desc.key;
+    }
+
+    int described = 0;
+    for (size_t id = 0; id < kAttributeOrdinals.size(); ++id) {
+        if (kAttributeOrdinals[id] >= 0)
+            ++described;
+    }
+    EXPECT_EQ(described, kAttributeCount);
+}
+
+/**
+ * @brief TEST keys and types
+ */
+TEST(TestDAttributeTable, keys)
+{
+    EXPECT_STREQ(DAttributeTable::key(DFileInfo::AttributeID::kStandardName), "standard::name");
+    EXPECT_STREQ(DAttributeTable::key(DFileInfo::AttributeID::kUnixInode), "unix::inode");
+    EXPECT_STREQ(DAttributeTable::key(DFileInfo::AttributeID::kStandardFilePath), "standard::file-path");
+    EXPECT_STREQ(DAttributeTable::key(DFileInfo::AttributeID::kAttributeIDMax), "");
+    EXPECT_STREQ(DAttributeTable::keyOf<DFileInfo::AttributeID::kTimeModified>(), "time::modified");
+
+    // every key is distinct
+    for (int i = 0; i < kAttributeCount; ++i) {
+        for (int j = i + 1; j < kAttributeCount; ++j)
+            EXPECT_STRNE(kAttributeDescriptors[i].key, kAttributeDescriptors[j].key);
+    }
+
+    // attributes DFileInfo computes itself are not read from GIO
+    EXPECT_EQ(DAttributeTable::type(DFileInfo::AttributeID::kStandardIsDir), DFileInfo::DFileAttributeType::kTypeInvalid);
+    EXPECT_EQ(DAttributeTable::type(DFileInfo::AttributeID::kAttributeIDMax), DFileInfo::DFileAttributeType::kTypeInvalid);
+}
+
+/**
+ * @brief TEST default values
+ */
+TEST(TestDAttributeTable, defaultValue)
+{
+    EXPECT_EQ(DAttributeTable::defaultValue(DFileInfo::AttributeID::kStandardSize), QVariant(0));
+    EXPECT_EQ(DAttributeTable::defaultValue(DFileInfo::AttributeID::kStandardIsHidden), QVariant(false));
+    EXPECT_EQ(DAttributeTable::defaultValue(DFileInfo::AttributeID::kAccessCanRead), QVariant(true));
+    EXPECT_EQ(DAttributeTable::defaultValue(DFileInfo::AttributeID::kAccessCanTrash), QVariant(false));
+    EXPECT_EQ(DAttributeTable::defaultValue(DFileInfo::AttributeID::kStandardName), QVariant(QString("")));
+    EXPECT_FALSE(DAttributeTable::defaultValue(DFileInfo::AttributeID::kAttributeIDMax).isValid());
+
+    // the default has the type the attribute is read as
+    for (const DAttributeDescriptor &desc : kAttributeDescriptors) {
+        const QVariant &value = DAttributeTable::defaultValue(desc.id);
+        EXPECT_TRUE(value.isValid()) << desc.key;
+        if (desc.type == DFileInfo::DFileAttributeType::kTypeBool)
+            EXPECT_EQ(value.type(), QVariant::Bool) << desc.key;
+        else if (desc.type == DFileInfo::DFileAttributeType::kTypeString || desc.type == DFileInfo::DFileAttributeType::kTypeByteString)
+            EXPECT_EQ(value.type(), QVariant::String) << desc.key;
+    }
+}
@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/ddirectorysizer.h>
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <atomic>
+
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDDirectorySizer : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        DDirectorySizer *sizer = nullptr;
+        std::atomic_int finishedCount { 0 };
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            // d0..d3 with f0..f9 and s/f0..s/f4 each, 100 bytes per file
+            QDir rootDir(dir->path());
+            for (int i = 0; i < 4; ++i) {
+                const QString sub = QString("d%1").arg(i);
+                ASSERT_TRUE(rootDir.mkpath(sub + "/s"));
+                for (int j = 0; j < 10; ++j)
+                    write(sub + QString("/f%1").arg(j));
+                for (int j = 0; j < 5; ++j)
+                    write(sub + QString("/s/f%1").arg(j));
+            }
+
+            sizer = new DDirectorySizer(QUrl::fromLocalFile(dir->path()));
+            sizer->setThreadCount(4);
+            QObject::connect(sizer, &DDirectorySizer::finished, sizer, [this]() {
+                ++finishedCount;
+            }, Qt::DirectConnection);
+        }
+
+        virtual void TearDown() override
+        {
+            delete sizer;
+            sizer = nullptr;
+            delete dir;
+            dir = nullptr;
+        }
+
+        void write(const QString &name)
+        {
+            QFile file(dir->filePath(name));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            file.write(QByteArray(100, 'x'));
+        }
+    };
+}
+
+/**
+ * @brief TEST_F totals of a finished walk
+ */
+TEST_F(TestDDirectorySizer, result)
+{
+    ASSERT_TRUE(sizer->start());
+    EXPECT_TRUE(sizer->waitForFinished());
+    EXPECT_FALSE(sizer->isRunning());
+    EXPECT_EQ(finishedCount, 1);
+
+    const DDirectorySizer::Result &result = sizer->result();
+    EXPECT_EQ(result.fileCount, 60);
+    EXPECT_EQ(result.dirCount, 8);
+    EXPECT_EQ(result.totalSize, 6000);
+    EXPECT_EQ(sizer->lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NONE);
+
+    // a second run starts from zero
+    ASSERT_TRUE(sizer->start());
+    EXPECT_TRUE(sizer->waitForFinished());
+    EXPECT_EQ(finishedCount, 2);
+    EXPECT_EQ(sizer->result().fileCount, 60);
+}
+
+/**
+ * @brief TEST_F hard links are counted once, symlinks are not followed
+ */
+TEST_F(TestDDirectorySizer, links)
+{
+    ASSERT_EQ(::link(qPrintable(dir->filePath("d0/f0")), qPrintable(dir->filePath("d1/link"))), 0);
+    ASSERT_EQ(::symlink(qPrintable(dir->path()), qPrintable(dir->filePath("d2/loop"))), 0);
+
+    ASSERT_TRUE(sizer->start());
+    EXPECT_TRUE(sizer->waitForFinished());
+
+    const DDirectorySizer::Result &result = sizer->result();
+    // the symlink itself is an entry
+    EXPECT_EQ(result.fileCount, 61);
+    EXPECT_EQ(result.dirCount, 8);
+}
+
+/**
+ * @brief TEST_F cancel ends the run with one finished()
+ */
+TEST_F(TestDDirectorySizer, cancel)
+{
+    sizer->setThreadCount(1);
+    ASSERT_TRUE(sizer->start());
+    sizer->cancel();
+
+    // the run may have ended before cancel(), finished() comes once either way
+    const bool complete = sizer->waitForFinished();
+    EXPECT_FALSE(sizer->isRunning());
+    EXPECT_EQ(finishedCount, 1);
+    // either a full result without error or a canceled one, never both
+    if (complete) {
+        EXPECT_EQ(sizer->result().fileCount, 60);
+        EXPECT_EQ(sizer->lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NONE);
+    } else {
+        EXPECT_EQ(sizer->lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_CANCELLED);
+    }
+
+    // and it can be started again
+    ASSERT_TRUE(sizer->start());
+    EXPECT_TRUE(sizer->waitForFinished());
+    EXPECT_EQ(finishedCount, 2);
+    EXPECT_EQ(sizer->result().fileCount, 60);
+}
+
+/**
+ * @brief TEST_F cancel after the walk is complete keeps the result
+ */
+TEST_F(TestDDirectorySizer, cancelFinished)
+{
+    ASSERT_TRUE(sizer->start());
+    EXPECT_TRUE(sizer->waitForFinished());
+    sizer->cancel();
+
+    EXPECT_EQ(finishedCount, 1);
+    EXPECT_EQ(sizer->result().fileCount, 60);
+    EXPECT_EQ(sizer->lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NONE);
+}
+
+/**
+ * @brief TEST_F deleting a running sizer joins its workers
+ */
+TEST_F(TestDDirectorySizer, destroyRunning)
+{
+    ASSERT_TRUE(sizer->start());
+    delete sizer;
+    sizer = nullptr;
+    SUCCEED();
+}
+
+/**
+ * @brief TEST only local urls are walked
+ */
+TEST(TestDDirectorySizerError, notLocal)
+{
+    DDirectorySizer sizer(QUrl("smb://host/share"));
+    EXPECT_FALSE(sizer.start());
+    EXPECT_EQ(sizer.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+}
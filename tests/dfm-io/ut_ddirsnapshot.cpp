@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/denumerator.h>
+#include <dfm-io/ddirsnapshot.h>
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <stdio.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDDirSnapshot : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            write("keep", "keep");
+            write("remove", "remove");
+            write("replace", "old");
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        void write(const QString &name, const QByteArray &data)
+        {
+            QFile file(dir->filePath(name));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            file.write(data);
+        }
+
+        QUrl url() const
+        {
+            return QUrl::fromLocalFile(dir->path());
+        }
+    };
+}
+
+/**
+ * @brief TEST_F snapshot
+ */
+TEST_F(TestDDirSnapshot, snapshot)
+{
+    DEnumerator enumerator(url());
+    DDirSnapshot snapshot = enumerator.snapshot();
+    EXPECT_TRUE(snapshot.isValid());
+    EXPECT_EQ(snapshot.dirUrl(), url());
+    EXPECT_EQ(snapshot.count(), 3);
+    EXPECT_TRUE(snapshot.contains("keep"));
+    EXPECT_FALSE(snapshot.contains("."));
+    EXPECT_FALSE(snapshot.contains(".."));
+}
+
+/**
+ * @brief TEST_F diff
+ */
+TEST_F(TestDDirSnapshot, diff)
+{
+    DEnumerator enumerator(url());
+    DDirSnapshot snapshot = enumerator.snapshot();
+    ASSERT_TRUE(snapshot.isValid());
+
+    EXPECT_TRUE(enumerator.diff(snapshot).isEmpty());
+
+    write("add", "add");
+    ASSERT_TRUE(QFile::remove(dir->filePath("remove")));
+    // another inode under the same name
+    write("replace.tmp", "new");
+    ASSERT_EQ(::rename(qPrintable(dir->filePath("replace.tmp")), qPrintable(dir->filePath("replace"))), 0);
+
+    const DDirSnapshot::Delta &delta = enumerator.diff(snapshot);
+    EXPECT_EQ(delta.added, QStringList { "add" });
+    EXPECT_EQ(delta.removed, QStringList { "remove" });
+    EXPECT_EQ(delta.modified, QStringList { "replace" });
+
+    // the snapshot is brought up to date
+    EXPECT_EQ(snapshot.count(), 3);
+    EXPECT_TRUE(snapshot.contains("add"));
+    EXPECT_FALSE(snapshot.contains("remove"));
+    EXPECT_TRUE(enumerator.diff(snapshot).isEmpty());
+}
+
+/**
+ * @brief TEST_F diff needs a snapshot of the same directory
+ */
+TEST_F(TestDDirSnapshot, invalidSnapshot)
+{
+    DEnumerator enumerator(url());
+    DDirSnapshot snapshot;
+    EXPECT_FALSE(snapshot.isValid());
+    EXPECT_TRUE(enumerator.diff(snapshot).isEmpty());
+    EXPECT_EQ(enumerator.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+
+    DEnumerator remote(QUrl("smb://host/share"));
+    EXPECT_FALSE(remote.snapshot().isValid());
+    EXPECT_EQ(remote.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+}
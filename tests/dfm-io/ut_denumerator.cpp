@@ -4,13 +4,22 @@
 
 #include "stub.h"
 
-#include <core/denumerator.h>
+#include <dfm-io/denumerator.h>
+#include <dfm-io/denumeratorfuture.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock-matchers.h>
 
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTimer>
 #include <QUrl>
 
+#include <unistd.h>
+
 #define private public
 #define protected public
 
@@ -41,6 +50,55 @@ namespace  {
             std::cout << "end TestDEnumerator TearDown" << std::endl;
         }
     };
+
+    class TestDEnumeratorLocal : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            // d0..d5 with "shown", "secret" and a .hidden naming "secret"
+            QDir rootDir(dir->path());
+            for (int i = 0; i < 6; ++i) {
+                const QString sub = QString("d%1").arg(i);
+                ASSERT_TRUE(rootDir.mkpath(sub));
+                write(sub + "/shown", "shown");
+                write(sub + "/secret", "secret");
+                write(sub + "/.hidden", "secret\n");
+            }
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        void write(const QString &name, const QByteArray &data)
+        {
+            QFile file(dir->filePath(name));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            file.write(data);
+        }
+
+        QUrl url() const
+        {
+            return QUrl::fromLocalFile(dir->path());
+        }
+
+        // paths relative to dir of everything listed
+        QSet<QString> list(DEnumerator &enumerator) const
+        {
+            QSet<QString> paths;
+            while (enumerator.hasNext())
+                paths.insert(enumerator.next().toLocalFile().mid(dir->path().length() + 1));
+            return paths;
+        }
+    };
 }
 
 /**
@@ -50,3 +108,216 @@ TEST_F(TestDEnumerator, getUri)
 {
     EXPECT_NO_FATAL_FAILURE(enumerator->uri());
 }
+
+/**
+ * @brief TEST_F .hidden lists are honored by the parallel walk as by the single threaded one
+ */
+TEST_F(TestDEnumeratorLocal, hiddenFilterParallel)
+{
+    const DEnumerator::DirFilters filters = DEnumerator::DirFilter::kAllEntries | DEnumerator::DirFilter::kNoDotAndDotDot;
+    QSet<QString> expected;
+    for (int i = 0; i < 6; ++i) {
+        expected.insert(QString("d%1").arg(i));
+        expected.insert(QString("d%1/shown").arg(i));
+    }
+
+    for (int threads : { 1, 4 }) {
+        DEnumerator enumerator(url(), {}, filters, DEnumerator::IteratorFlag::kSubdirectories);
+        enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+        enumerator.setThreadCount(threads);
+        EXPECT_EQ(list(enumerator), expected) << threads;
+    }
+}
+
+/**
+ * @brief TEST_F fileCount() of a filtered parallel walk counts what the enumeration lists
+ */
+TEST_F(TestDEnumeratorLocal, fileCountHiddenFilter)
+{
+    const DEnumerator::DirFilters filters = DEnumerator::DirFilter::kAllEntries | DEnumerator::DirFilter::kNoDotAndDotDot;
+    for (int threads : { 1, 4 }) {
+        DEnumerator enumerator(url(), {}, filters, DEnumerator::IteratorFlag::kSubdirectories);
+        enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+        enumerator.setThreadCount(threads);
+        EXPECT_EQ(enumerator.fileCount(), 12u) << threads;
+    }
+
+    // every entry without filters: 6 directories with 3 files each
+    DEnumerator all(url(), {}, DEnumerator::DirFilter::kNoFilter, DEnumerator::IteratorFlag::kSubdirectories);
+    all.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+    all.setThreadCount(4);
+    EXPECT_EQ(all.fileCount(), 24u);
+}
+
+/**
+ * @brief TEST_F fileCount() stops on symlink loops when following links
+ */
+TEST_F(TestDEnumeratorLocal, fileCountSymlinkLoop)
+{
+    ASSERT_EQ(::symlink(qPrintable(dir->path()), qPrintable(dir->filePath("d0/loop"))), 0);
+
+    DEnumerator enumerator(url(), {}, DEnumerator::DirFilter::kNoFilter,
+                           DEnumerator::IteratorFlag::kSubdirectories | DEnumerator::IteratorFlag::kFollowSymlinks);
+    enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+    // the link is counted, the tree it points to is not walked again
+    EXPECT_EQ(enumerator.fileCount(), 25u);
+}
+
+/**
+ * @brief TEST_F the system backend lists what the gio backend lists
+ */
+TEST_F(TestDEnumeratorLocal, systemMatchesGio)
+{
+    write(".dot", "dot");
+    ASSERT_EQ(::symlink("shown", qPrintable(dir->filePath("d0/link"))), 0);
+    ASSERT_EQ(::symlink("missing", qPrintable(dir->filePath("d1/dangling"))), 0);
+
+    const QList<DEnumerator::DirFilters> filterList {
+        DEnumerator::DirFilter::kAllEntries | DEnumerator::DirFilter::kNoDotAndDotDot,
+        DEnumerator::DirFilter::kAllEntries | DEnumerator::DirFilter::kHidden | DEnumerator::DirFilter::kNoDotAndDotDot,
+        DEnumerator::DirFilter::kFiles | DEnumerator::DirFilter::kNoSymLinks | DEnumerator::DirFilter::kNoDotAndDotDot,
+        DEnumerator::DirFilter::kDirs | DEnumerator::DirFilter::kNoDotAndDotDot,
+    };
+    for (const DEnumerator::DirFilters &filters : filterList) {
+        for (auto flags : { DEnumerator::IteratorFlags(), DEnumerator::IteratorFlags(DEnumerator::IteratorFlag::kSubdirectories) }) {
+            DEnumerator gio(url(), {}, filters, flags);
+            gio.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorGio);
+            DEnumerator system(url(), {}, filters, flags);
+            system.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+
+            const QSet<QString> &expected = list(gio);
+            EXPECT_FALSE(expected.isEmpty());
+            EXPECT_EQ(list(system), expected) << int(filters) << " " << int(flags);
+        }
+    }
+}
+
+/**
+ * @brief TEST_F infos of the system backend carry the values of the file
+ */
+TEST_F(TestDEnumeratorLocal, systemFileInfo)
+{
+    DEnumerator enumerator(QUrl::fromLocalFile(dir->filePath("d0")), {}, DEnumerator::DirFilter::kFiles, DEnumerator::IteratorFlags());
+    enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+
+    int count = 0;
+    while (enumerator.hasNext()) {
+        const QUrl &next = enumerator.next();
+        if (next.fileName() != "shown")
+            continue;
+        ++count;
+        const QSharedPointer<DFileInfo> &info = enumerator.fileInfo();
+        ASSERT_TRUE(info);
+        EXPECT_EQ(info->uri(), next);
+        EXPECT_EQ(info->attribute(DFileInfo::AttributeID::kStandardName).toString(), QString("shown"));
+        EXPECT_EQ(info->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 5u);
+        EXPECT_FALSE(info->attribute(DFileInfo::AttributeID::kStandardIsDir).toBool());
+    }
+    EXPECT_EQ(count, 1);
+}
+
+/**
+ * @brief TEST_F a followed symlink to an ancestor is listed but not walked again
+ */
+TEST_F(TestDEnumeratorLocal, systemSymlinkLoop)
+{
+    ASSERT_EQ(::symlink(qPrintable(dir->path()), qPrintable(dir->filePath("d0/loop"))), 0);
+
+    DEnumerator enumerator(url(), {}, DEnumerator::DirFilter::kNoFilter,
+                           DEnumerator::IteratorFlag::kSubdirectories | DEnumerator::IteratorFlag::kFollowSymlinks);
+    enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+
+    const QSet<QString> &paths = list(enumerator);
+    EXPECT_TRUE(paths.contains("d0/loop"));
+    EXPECT_FALSE(paths.contains("d0/loop/d0"));
+    // 6 directories with 3 files each, and the link
+    EXPECT_EQ(paths.size(), 25);
+}
+
+/**
+ * @brief TEST_F a missing directory fails with the error of the open
+ */
+TEST_F(TestDEnumeratorLocal, systemMissing)
+{
+    DEnumerator enumerator(QUrl::fromLocalFile(dir->filePath("missing")));
+    enumerator.setEnumeratorType(DEnumerator::EnumeratorType::kEnumeratorSystem);
+    EXPECT_FALSE(enumerator.hasNext());
+    EXPECT_EQ(enumerator.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_FOUND);
+}
+
+/**
+ * @brief TEST_F async results arrive in batches of at most batchSize() entries
+ */
+TEST_F(TestDEnumeratorLocal, asyncBatches)
+{
+    for (int i = 0; i < 10; ++i)
+        write(QString("f%1").arg(i), "file");
+
+    QSharedPointer<DEnumerator> enumerator(new DEnumerator(url(), {}, DEnumerator::DirFilter::kAllEntries | DEnumerator::DirFilter::kNoDotAndDotDot,
+                                                           DEnumerator::IteratorFlags()));
+    enumerator->setBatchSize(4);
+    QScopedPointer<DEnumeratorFuture> future(enumerator->asyncIterator());
+
+    QList<int> batchSizes;
+    QSet<QString> names;
+    QEventLoop loop;
+    QObject::connect(future.data(), &DEnumeratorFuture::batchReady, &loop, [&](const QList<QSharedPointer<DFileInfo>> &infos) {
+        batchSizes.append(infos.size());
+        for (const auto &info : infos)
+            names.insert(info->uri().fileName());
+    });
+    QObject::connect(future.data(), &DEnumeratorFuture::asyncIteratorOver, &loop, &QEventLoop::quit);
+    QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+    future->startAsyncIterator();
+    loop.exec();
+
+    EXPECT_TRUE(future->isFinished());
+    // 6 directories and 10 files
+    EXPECT_EQ(names.size(), 16);
+    EXPECT_GE(batchSizes.size(), 4);
+    for (int size : batchSizes)
+        EXPECT_LE(size, 4);
+}
+
+/**
+ * @brief TEST_F pages put together give the order of sortFileInfoList()
+ */
+TEST_F(TestDEnumeratorLocal, sortFileInfoPage)
+{
+    for (int i = 0; i < 40; ++i)
+        write(QString("f%1").arg(i), QByteArray(i + 1, 'x'));
+
+    auto urlsOf = [](const QList<QSharedPointer<DEnumerator::SortFileInfo>> &infos) {
+        QList<QUrl> urls;
+        for (const auto &info : infos)
+            urls.append(info->url);
+        return urls;
+    };
+    auto sortedUrls = [&](DEnumerator::SortRoleCompareFlag role, Qt::SortOrder order) {
+        DEnumerator enumerator(url());
+        enumerator.setSortRole(role);
+        enumerator.setSortOrder(order);
+        return urlsOf(enumerator.sortFileInfoList());
+    };
+
+    DEnumerator enumerator(url());
+    enumerator.setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName);
+    enumerator.setSortOrder(Qt::AscendingOrder);
+    const QList<QUrl> &byName = sortedUrls(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName, Qt::AscendingOrder);
+    ASSERT_EQ(byName.size(), 46);
+
+    QList<QUrl> pages;
+    for (int offset = 0; offset < byName.size(); offset += 7)
+        pages.append(urlsOf(enumerator.sortFileInfoPage(offset, 7)));
+    EXPECT_EQ(pages, byName);
+    EXPECT_TRUE(enumerator.sortFileInfoPage(byName.size(), 7).isEmpty());
+    EXPECT_TRUE(enumerator.sortFileInfoPage(-1, 7).isEmpty());
+    EXPECT_TRUE(enumerator.sortFileInfoPage(0, 0).isEmpty());
+
+    // another order of the same entries
+    enumerator.setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize);
+    enumerator.setSortOrder(Qt::DescendingOrder);
+    const QList<QUrl> &bySize = sortedUrls(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize, Qt::DescendingOrder);
+    EXPECT_EQ(urlsOf(enumerator.sortFileInfoPage(6, 5)), bySize.mid(6, 5));
+    EXPECT_EQ(urlsOf(enumerator.sortFileInfoPage(40, 10)), bySize.mid(40));
+}
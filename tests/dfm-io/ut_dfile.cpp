@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dfile.h>
+#include <dfm-io/dfilemapping.h>
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    struct AsyncResult
+    {
+        bool done { false };
+        qint64 size { 0 };
+    };
+
+    void sizeCallback(qint64 size, void *userData)
+    {
+        AsyncResult *result = static_cast<AsyncResult *>(userData);
+        result->size = size;
+        result->done = true;
+    }
+
+    // the callbacks come from the main loop of this thread
+    bool waitFor(const AsyncResult &result)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!result.done && timer.elapsed() < 10000)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        return result.done;
+    }
+
+    class TestDFile : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        QString filePath;
+        QByteArray content;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            // a few pages and a bit, no two neighbouring pages alike
+            content.resize(3 * 4096 + 100);
+            for (int i = 0; i < content.size(); ++i)
+                content[i] = static_cast<char>(i % 251);
+            filePath = dir->filePath("file.bin");
+            QFile file(filePath);
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            ASSERT_EQ(file.write(content), content.size());
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        QByteArray fileContent() const
+        {
+            QFile file(filePath);
+            if (!file.open(QIODevice::ReadOnly))
+                return QByteArray();
+            return file.readAll();
+        }
+    };
+}
+
+/**
+ * @brief TEST_F map the whole file and a range at an offset that is not page aligned
+ */
+TEST_F(TestDFile, map)
+{
+    DFile file(filePath);
+
+    const DFileMapping &all = file.map();
+    ASSERT_TRUE(all.isValid());
+    EXPECT_EQ(all.offset(), 0);
+    EXPECT_EQ(all.size(), content.size());
+    EXPECT_EQ(QByteArray(all.data(), static_cast<int>(all.size())), content);
+    EXPECT_EQ(all.toByteArray(), content);
+
+    const DFileMapping &part = file.map(4097, 5000, DFileMapping::Advice::kSequential);
+    ASSERT_TRUE(part.isValid());
+    EXPECT_EQ(part.offset(), 4097);
+    EXPECT_EQ(part.size(), 5000);
+    EXPECT_EQ(part.toByteArray(), content.mid(4097, 5000));
+    EXPECT_TRUE(part.advise(DFileMapping::Advice::kWillNeed, 10, 100));
+
+    // up to the end from an odd offset
+    const DFileMapping &tail = file.map(12345);
+    ASSERT_TRUE(tail.isValid());
+    EXPECT_EQ(tail.toByteArray(), content.mid(12345));
+}
+
+/**
+ * @brief TEST_F a mapping outlives its DFile, copies share it
+ */
+TEST_F(TestDFile, mapOutlivesFile)
+{
+    DFileMapping copy;
+    EXPECT_FALSE(copy.isValid());
+    {
+        DFile file(filePath);
+        ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+        const DFileMapping &mapping = file.map(100, 200);
+        ASSERT_TRUE(file.close());
+        copy = mapping;
+    }
+    ASSERT_TRUE(copy.isValid());
+    EXPECT_EQ(copy.toByteArray(), content.mid(100, 200));
+}
+
+/**
+ * @brief TEST_F ranges outside the file and files that are not local are refused
+ */
+TEST_F(TestDFile, mapInvalid)
+{
+    DFile file(filePath);
+    EXPECT_FALSE(file.map(content.size() + 1).isValid());
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+    EXPECT_FALSE(file.map(0, content.size() + 1).isValid());
+    EXPECT_FALSE(file.map(-1).isValid());
+
+    DFile missing(dir->filePath("missing"));
+    EXPECT_FALSE(missing.map().isValid());
+    EXPECT_EQ(missing.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_FOUND);
+
+    DFile directory(dir->path());
+    EXPECT_FALSE(directory.map().isValid());
+
+    DFile remote(QUrl("smb://host/share/file"));
+    EXPECT_FALSE(remote.map().isValid());
+    EXPECT_EQ(remote.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_SUPPORTED);
+}
+
+/**
+ * @brief TEST_F async writes and reads of both engines, the stream position follows them
+ */
+TEST_F(TestDFile, asyncEngines)
+{
+    for (DFile::AsyncEngine engine : { DFile::AsyncEngine::kGio, DFile::AsyncEngine::kIoUring }) {
+        const QString path = dir->filePath(QString("async%1.bin").arg(int(engine)));
+        {
+            DFile file(path);
+            file.setAsyncEngine(engine);
+            EXPECT_EQ(file.asyncEngine(), engine);
+            ASSERT_TRUE(file.open(DFile::OpenFlag::kWriteOnly | DFile::OpenFlag::kTruncate));
+
+            AsyncResult first;
+            file.writeAsync(content.constData(), 5000, 0, sizeCallback, &first);
+            ASSERT_TRUE(waitFor(first));
+            EXPECT_EQ(first.size, 5000);
+            AsyncResult second;
+            file.writeAsync(content.constData() + 5000, content.size() - 5000, 0, sizeCallback, &second);
+            ASSERT_TRUE(waitFor(second));
+            EXPECT_EQ(second.size, content.size() - 5000);
+            EXPECT_EQ(file.pos(), content.size());
+            ASSERT_TRUE(file.close());
+        }
+
+        QFile written(path);
+        ASSERT_TRUE(written.open(QIODevice::ReadOnly));
+        EXPECT_EQ(written.readAll(), content) << int(engine);
+
+        DFile file(path);
+        file.setAsyncEngine(engine);
+        ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+        QByteArray buffer(content.size(), '\0');
+        AsyncResult head;
+        file.readAsync(buffer.data(), 100, 0, sizeCallback, &head);
+        ASSERT_TRUE(waitFor(head));
+        EXPECT_EQ(head.size, 100);
+        AsyncResult next;
+        file.readAsync(buffer.data() + 100, 100, 0, sizeCallback, &next);
+        ASSERT_TRUE(waitFor(next));
+        EXPECT_EQ(next.size, 100);
+        EXPECT_EQ(buffer.left(200), content.left(200));
+
+        AsyncResult rest;
+        file.readAsync(buffer.data(), buffer.size(), 0, sizeCallback, &rest);
+        ASSERT_TRUE(waitFor(rest));
+        EXPECT_EQ(rest.size, content.size() - 200);
+        EXPECT_EQ(buffer.left(static_cast<int>(rest.size)), content.mid(200));
+    }
+}
+
+/**
+ * @brief TEST_F positional reads leave the stream position alone
+ */
+TEST_F(TestDFile, readAt)
+{
+    DFile file(filePath);
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+
+    QByteArray buffer(100, '\0');
+    EXPECT_EQ(file.readAt(4097, buffer.data(), buffer.size()), 100);
+    EXPECT_EQ(buffer, content.mid(4097, 100));
+    EXPECT_EQ(file.pos(), 0);
+    EXPECT_EQ(file.read(10), content.left(10));
+
+    // short at the end, 0 past it
+    EXPECT_EQ(file.readAt(content.size() - 10, buffer.data(), buffer.size()), 10);
+    EXPECT_EQ(file.readAt(content.size() + 10, buffer.data(), buffer.size()), 0);
+    EXPECT_EQ(file.readAt(-1, buffer.data(), buffer.size()), -1);
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+
+    QByteArray first(50, '\0');
+    QByteArray second(70, '\0');
+    const DFile::Segment segments[] { { first.data(), first.size() }, { second.data(), second.size() } };
+    EXPECT_EQ(file.readv(1000, segments, 2), 120);
+    EXPECT_EQ(first + second, content.mid(1000, 120));
+    EXPECT_EQ(file.pos(), 10);
+}
+
+/**
+ * @brief TEST_F positional writes land at their offsets, the file ends up as a plain write would leave it
+ */
+TEST_F(TestDFile, writeAt)
+{
+    const QString path = dir->filePath("positional.bin");
+    {
+        DFile file(path);
+        ASSERT_TRUE(file.open(DFile::OpenFlag::kReadWrite));
+        EXPECT_EQ(file.writeAt(100, "abc", 3), 3);
+        EXPECT_EQ(file.writeAt(0, "xy", 2), 2);
+
+        char one[] = "12";
+        char two[] = "345";
+        const DFile::Segment segments[] { { one, 2 }, { two, 3 } };
+        EXPECT_EQ(file.writev(10, segments, 2), 5);
+        EXPECT_EQ(file.pos(), 0);
+
+        // written data is read back through the same file
+        char buffer[5] {};
+        EXPECT_EQ(file.readAt(10, buffer, 5), 5);
+        EXPECT_EQ(QByteArray(buffer, 5), QByteArray("12345"));
+        ASSERT_TRUE(file.close());
+    }
+
+    QByteArray expected(103, '\0');
+    expected.replace(0, 2, "xy");
+    expected.replace(10, 5, "12345");
+    expected.replace(100, 3, "abc");
+    QFile written(path);
+    ASSERT_TRUE(written.open(QIODevice::ReadOnly));
+    EXPECT_EQ(written.readAll(), expected);
+}
+
+/**
+ * @brief TEST_F files opened to append refuse positional writes
+ */
+TEST_F(TestDFile, writeAtAppend)
+{
+    DFile file(filePath);
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kAppend));
+    EXPECT_EQ(file.writeAt(0, "abc", 3), -1);
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+
+    char data[] = "abc";
+    const DFile::Segment segment { data, 3 };
+    EXPECT_EQ(file.writev(0, &segment, 1), -1);
+
+    EXPECT_EQ(file.write(QByteArray("tail")), 4);
+    ASSERT_TRUE(file.close());
+    EXPECT_EQ(fileContent(), content + "tail");
+
+    // and a file that is not open has no stream to use
+    DFile closed(filePath);
+    EXPECT_EQ(closed.writeAt(0, "abc", 3), -1);
+    EXPECT_EQ(closed.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_OPEN_FAILED);
+}
+
+/**
+ * @brief TEST_F several threads read one open file at once
+ */
+TEST_F(TestDFile, readAtThreads)
+{
+    DFile file(filePath);
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+
+    std::atomic_int mismatches { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            char buffer[333];
+            for (int i = 0; i < 200; ++i) {
+                const qint64 offset = (t * 997 + i * 61) % (content.size() - 333);
+                if (file.readAt(offset, buffer, sizeof(buffer)) != qint64(sizeof(buffer))
+                    || QByteArray(buffer, sizeof(buffer)) != content.mid(static_cast<int>(offset), sizeof(buffer)))
+                    ++mismatches;
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(file.pos(), 0);
+}
+
+/**
+ * @brief TEST_F hints of the open file need it open, page cache hints work on a closed file too
+ */
+TEST_F(TestDFile, advise)
+{
+    DFile file(filePath);
+    EXPECT_FALSE(file.advise(DFile::AccessHint::kSequential));
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_OPEN_FAILED);
+    EXPECT_TRUE(file.advise(DFile::AccessHint::kWillNeed));
+    EXPECT_TRUE(file.advise(DFile::AccessHint::kDontNeed, 4096, 4096));
+
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+    for (auto hint : { DFile::AccessHint::kSequential, DFile::AccessHint::kRandom, DFile::AccessHint::kNoReuse,
+                       DFile::AccessHint::kWillNeed, DFile::AccessHint::kDontNeed, DFile::AccessHint::kNormal })
+        EXPECT_TRUE(file.advise(hint)) << int(hint);
+    EXPECT_FALSE(file.advise(DFile::AccessHint::kRandom, -1));
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+
+    // hints never change what is read
+    EXPECT_EQ(file.readAll(), content);
+}
+
+/**
+ * @brief TEST_F hints of a file open for writing, dropped pages keep the written data
+ */
+TEST_F(TestDFile, adviseWritten)
+{
+    const QString path = dir->filePath("written.bin");
+    DFile file(path);
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kWriteOnly));
+    ASSERT_EQ(file.write(content), content.size());
+    EXPECT_TRUE(file.advise(DFile::AccessHint::kDontNeed));
+    ASSERT_TRUE(file.close());
+
+    QFile written(path);
+    ASSERT_TRUE(written.open(QIODevice::ReadOnly));
+    EXPECT_EQ(written.readAll(), content);
+}
+
+/**
+ * @brief TEST_F readahead of open and closed files, missing files fail, other backends ignore it
+ */
+TEST_F(TestDFile, readahead)
+{
+    DFile file(filePath);
+    // some file systems, e.g. tmpfs on newer kernels, have no readahead
+    if (!file.readahead(0, content.size()))
+        EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+    ASSERT_TRUE(file.open(DFile::OpenFlag::kReadOnly));
+    if (!file.readahead(4096, 0))
+        EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+    EXPECT_FALSE(file.readahead(-1, 10));
+    EXPECT_EQ(file.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_INVALID_ARGUMENT);
+
+    DFile missing(dir->filePath("missing"));
+    EXPECT_FALSE(missing.readahead(0, 10));
+    EXPECT_EQ(missing.lastError().code(), DFMIOErrorCode::DFM_IO_ERROR_NOT_FOUND);
+    EXPECT_FALSE(missing.advise(DFile::AccessHint::kWillNeed));
+
+    DFile remote(QUrl("smb://host/share/file"));
+    EXPECT_TRUE(remote.readahead(0, 10));
+    EXPECT_TRUE(remote.advise(DFile::AccessHint::kSequential));
+}
@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stub.h"
+
+#include "utils/dlocalhelper.h"
+
+#include <dfm-io/dfileinfo.h>
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <gio/gio.h>
+
+#include <type_traits>
+
+#include <sys/stat.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    int queryInfoCount = 0;
+
+    GFileInfo *countQueryInfo(GFile *, const char *, GFileQueryInfoFlags, GCancellable *, GError **)
+    {
+        ++queryInfoCount;
+        return nullptr;
+    }
+
+    int readCount = 0;
+
+    QVariant countAttributeFromGFileInfo(GFileInfo *, DFileInfo::AttributeID, DFMIOErrorCode &)
+    {
+        ++readCount;
+        return QVariant(QString("stubbed"));
+    }
+
+    class TestDFileInfo : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        QString filePath;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            filePath = dir->filePath("file.txt");
+            QFile file(filePath);
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            file.write("0123456789");
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+    };
+}
+
+/**
+ * @brief TEST_F attributes outside the query are loaded by namespace, missing requested ones are not queried again
+ */
+TEST_F(TestDFileInfo, lazyAttributes)
+{
+    DFileInfo info(QUrl::fromLocalFile(filePath), "standard::*");
+    ASSERT_TRUE(info.initQuerier());
+
+    Stub stub;
+    stub.set(g_file_query_info, countQueryInfo);
+    queryInfoCount = 0;
+
+    // asked for, a regular file has no symlink target
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardSymlinkTarget).toString(), QString());
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardSymlinkTarget).toString(), QString());
+    EXPECT_EQ(queryInfoCount, 0);
+
+    // not asked for: "owner::*" is queried once for the whole namespace
+    info.attribute(DFileInfo::AttributeID::kOwnerUser);
+    info.attribute(DFileInfo::AttributeID::kOwnerGroup);
+    info.attribute(DFileInfo::AttributeID::kOwnerUser);
+    EXPECT_EQ(queryInfoCount, 1);
+}
+
+/**
+ * @brief TEST_F a lazily loaded namespace gives the real values
+ */
+TEST_F(TestDFileInfo, lazyAttributeValues)
+{
+    DFileInfo info(QUrl::fromLocalFile(filePath), "standard::name");
+    ASSERT_TRUE(info.initQuerier());
+
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardName).toString(), QString("file.txt"));
+    EXPECT_FALSE(info.attribute(DFileInfo::AttributeID::kOwnerUser).toString().isEmpty());
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardContentType).toString(), QString("text/plain"));
+}
+
+/**
+ * @brief TEST_F queried with "*", nothing is loaded later
+ */
+TEST_F(TestDFileInfo, lazyAttributesAll)
+{
+    DFileInfo info(QUrl::fromLocalFile(filePath));
+    ASSERT_TRUE(info.initQuerier());
+
+    Stub stub;
+    stub.set(g_file_query_info, countQueryInfo);
+    queryInfoCount = 0;
+
+    info.attribute(DFileInfo::AttributeID::kStandardSymlinkTarget);
+    info.attribute(DFileInfo::AttributeID::kOwnerUser);
+    EXPECT_EQ(queryInfoCount, 0);
+}
+
+/**
+ * @brief TEST_F stat attributes of an info not queried yet come from statx, gio is not asked
+ */
+TEST_F(TestDFileInfo, statAttributes)
+{
+    struct stat st;
+    ASSERT_EQ(::stat(qPrintable(filePath), &st), 0);
+
+    DFileInfo info(QUrl::fromLocalFile(filePath));
+    {
+        Stub stub;
+        stub.set(g_file_query_info, countQueryInfo);
+        queryInfoCount = 0;
+
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 10u);
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kUnixMode).toUInt(), st.st_mode);
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kUnixInode).toULongLong(), st.st_ino);
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kUnixUID).toUInt(), st.st_uid);
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kTimeModified).toULongLong(), quint64(st.st_mtime));
+        EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kTimeChanged).toULongLong(), quint64(st.st_ctime));
+        EXPECT_EQ(queryInfoCount, 0);
+    }
+
+    // a refresh stats again
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("0123456789");
+    file.close();
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 10u);
+    ASSERT_TRUE(info.refresh());
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 20u);
+}
+
+/**
+ * @brief TEST_F values are read from the GFileInfo once, a refresh drops them
+ */
+TEST_F(TestDFileInfo, cachedAttributes)
+{
+    DFileInfo info(QUrl::fromLocalFile(filePath));
+    ASSERT_TRUE(info.initQuerier());
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardName).toString(), QString("file.txt"));
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardContentType).toString(), QString("text/plain"));
+
+    Stub stub;
+    stub.set(ADDR(DLocalHelper, attributeFromGFileInfo), countAttributeFromGFileInfo);
+    readCount = 0;
+
+    bool success = false;
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardName, &success).toString(), QString("file.txt"));
+    EXPECT_TRUE(success);
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardContentType).toString(), QString("text/plain"));
+    EXPECT_EQ(readCount, 0);
+
+    ASSERT_TRUE(info.refresh());
+    EXPECT_EQ(info.attribute(DFileInfo::AttributeID::kStandardContentType).toString(), QString("stubbed"));
+    EXPECT_EQ(readCount, 1);
+}
+
+/**
+ * @brief TEST_F typed reads give the values of attribute()
+ */
+TEST_F(TestDFileInfo, typedAccessors)
+{
+    static_assert(std::is_same<decltype(std::declval<DFileInfo>().get<DFileInfo::AttributeID::kStandardSize>()), quint64>::value,
+                  "standard::size is read as quint64");
+    static_assert(std::is_same<decltype(std::declval<DFileInfo>().get<DFileInfo::AttributeID::kUnixMode>()), quint32>::value,
+                  "unix::mode is read as quint32");
+    static_assert(std::is_same<decltype(std::declval<DFileInfo>().get<DFileInfo::AttributeID::kStandardIsHidden>()), bool>::value,
+                  "standard::is-hidden is read as bool");
+    static_assert(std::is_same<decltype(std::declval<DFileInfo>().get<DFileInfo::AttributeID::kStandardName>()), QString>::value,
+                  "standard::name is read as QString");
+
+    DFileInfo info(QUrl::fromLocalFile(filePath));
+    ASSERT_TRUE(info.initQuerier());
+
+    EXPECT_EQ(info.size(), 10);
+    EXPECT_EQ(info.size(), info.attribute(DFileInfo::AttributeID::kStandardSize).toLongLong());
+    EXPECT_EQ(info.mode(), info.attribute(DFileInfo::AttributeID::kUnixMode).toUInt());
+    EXPECT_EQ(info.inode(), info.attribute(DFileInfo::AttributeID::kUnixInode).toULongLong());
+    EXPECT_EQ(info.name(), QString("file.txt"));
+    EXPECT_EQ(info.displayName(), info.attribute(DFileInfo::AttributeID::kStandardDisplayName).toString());
+
+    EXPECT_EQ(info.get<DFileInfo::AttributeID::kStandardSize>(), 10u);
+    EXPECT_FALSE(info.get<DFileInfo::AttributeID::kStandardIsHidden>());
+    EXPECT_EQ(info.get<DFileInfo::AttributeID::kStandardName>(), QString("file.txt"));
+    // read again from the cached value
+    EXPECT_EQ(info.get<DFileInfo::AttributeID::kStandardName>(), QString("file.txt"));
+}
+
+/**
+ * @brief TEST_F typed reads of a missing file give the defaults
+ */
+TEST_F(TestDFileInfo, typedAccessorsMissing)
+{
+    DFileInfo info(QUrl::fromLocalFile(dir->filePath("missing")));
+    EXPECT_EQ(info.size(), 0);
+    EXPECT_EQ(info.inode(), 0u);
+    EXPECT_EQ(info.get<DFileInfo::AttributeID::kStandardSize>(), 0u);
+}
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dfileinfobatch.h>
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDFileInfoBatch : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        QMutex mutex;
+        QHash<QUrl, QSharedPointer<DFileInfo>> infos;
+        QList<QUrl> failed;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            QFile file(dir->filePath("file.txt"));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            file.write("0123456789");
+            file.close();
+            ASSERT_EQ(::symlink("file.txt", qPrintable(dir->filePath("link"))), 0);
+            ASSERT_EQ(::symlink("missing.txt", qPrintable(dir->filePath("dangling"))), 0);
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        QUrl url(const QString &name) const
+        {
+            return QUrl::fromLocalFile(dir->filePath(name));
+        }
+
+        void run(DFileInfoBatch *batch)
+        {
+            // the signals come from the workers
+            QObject::connect(batch, &DFileInfoBatch::infosReady, batch, [this](const QList<QSharedPointer<DFileInfo>> &list) {
+                QMutexLocker lk(&mutex);
+                for (const auto &info : list)
+                    infos.insert(info->uri(), info);
+            }, Qt::DirectConnection);
+            QObject::connect(batch, &DFileInfoBatch::infosFailed, batch, [this](const QList<QUrl> &urls) {
+                QMutexLocker lk(&mutex);
+                failed.append(urls);
+            }, Qt::DirectConnection);
+
+            ASSERT_TRUE(batch->start());
+            EXPECT_TRUE(batch->waitForFinished());
+            EXPECT_EQ(batch->finishedCount(), batch->urls().size());
+        }
+    };
+}
+
+/**
+ * @brief TEST_F a dangling symlink gets an info when following symlinks, a missing file fails
+ */
+TEST_F(TestDFileInfoBatch, danglingSymlink)
+{
+    DFileInfoBatch batch({ url("file.txt"), url("link"), url("dangling"), url("missing.txt") });
+    batch.setThreadCount(2);
+    run(&batch);
+
+    EXPECT_EQ(infos.size(), 3);
+    EXPECT_EQ(failed, QList<QUrl>({ url("missing.txt") }));
+    ASSERT_TRUE(infos.contains(url("dangling")));
+    EXPECT_TRUE(infos.value(url("dangling"))->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool());
+
+    // followed: the size of the target
+    ASSERT_TRUE(infos.contains(url("link")));
+    EXPECT_EQ(infos.value(url("link"))->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 10u);
+}
+
+/**
+ * @brief TEST_F the stat of an info follows the query flag
+ */
+TEST_F(TestDFileInfoBatch, noFollowSymlinks)
+{
+    DFileInfoBatch batch({ url("link"), url("dangling") });
+    batch.setQueryInfoFlag(DFileInfo::FileQueryInfoFlags::kTypeNoFollowSymlinks);
+    run(&batch);
+
+    EXPECT_TRUE(failed.isEmpty());
+    ASSERT_EQ(infos.size(), 2);
+    // not followed: the size of the link, the length of "file.txt"
+    EXPECT_EQ(infos.value(url("link"))->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 8u);
+    EXPECT_TRUE(infos.value(url("link"))->attribute(DFileInfo::AttributeID::kStandardIsSymlink).toBool());
+}
+
+/**
+ * @brief TEST_F stat attributes only: local files are not queried, the values come from the batch's statx
+ */
+TEST_F(TestDFileInfoBatch, statAttributes)
+{
+    DFileInfoBatch batch({ url("file.txt"), url("link"), url("dangling") });
+    batch.setQueryAttributes({ DFileInfo::AttributeID::kStandardSize });
+    run(&batch);
+
+    EXPECT_TRUE(failed.isEmpty());
+    ASSERT_EQ(infos.size(), 3);
+    EXPECT_EQ(infos.value(url("file.txt"))->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 10u);
+    EXPECT_EQ(infos.value(url("link"))->attribute(DFileInfo::AttributeID::kStandardSize).toULongLong(), 10u);
+}
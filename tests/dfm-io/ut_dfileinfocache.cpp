@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dfileinfocache.h>
+#include <dfm-io/dwatcher.h>
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QUrl>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDFileInfoCache : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        DFileInfoCache *cache = nullptr;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            // a/file, a/b/file, a/b/c/file
+            ASSERT_TRUE(QDir(dir->path()).mkpath("a/b/c"));
+            for (const QString &name : { "a/file", "a/b/file", "a/b/c/file" }) {
+                QFile file(dir->filePath(name));
+                ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            }
+
+            cache = DFileInfoCache::instance();
+            cache->clear();
+            cache->setMaxCount(10000);
+        }
+
+        virtual void TearDown() override
+        {
+            cache->clear();
+            delete dir;
+            dir = nullptr;
+        }
+
+        QUrl url(const QString &name) const
+        {
+            return QUrl::fromLocalFile(dir->filePath(name));
+        }
+    };
+}
+
+/**
+ * @brief TEST_F cached infos are shared, the least recently used ones are dropped
+ */
+TEST_F(TestDFileInfoCache, lookup)
+{
+    const auto &info = cache->info(url("a/file"));
+    ASSERT_TRUE(info);
+    EXPECT_EQ(cache->cachedInfo(url("a/file")), info);
+    // the same key with a dot segment
+    EXPECT_EQ(cache->cachedInfo(url("a/./file")), info);
+    EXPECT_FALSE(cache->info(url("missing")));
+
+    cache->info(url("a/b/file"));
+    cache->info(url("a/b/c/file"));
+    EXPECT_EQ(cache->count(), 3);
+
+    // a/file was used last, a/b/file is dropped first
+    cache->cachedInfo(url("a/file"));
+    cache->setMaxCount(2);
+    EXPECT_FALSE(cache->cachedInfo(url("a/b/file")));
+    EXPECT_TRUE(cache->cachedInfo(url("a/file")));
+}
+
+/**
+ * @brief TEST_F deleting a directory drops everything below it, at any depth
+ */
+TEST_F(TestDFileInfoCache, invalidateNested)
+{
+    // nothing directly in a/b is cached, only a/b/c/file below it
+    for (const QString &name : { "a", "a/file", "a/b/c/file" })
+        ASSERT_TRUE(cache->info(url(name)));
+
+    DWatcher watcher(QUrl::fromLocalFile(dir->path()));
+    cache->attachWatcher(&watcher);
+
+    Q_EMIT watcher.fileDeleted(url("a/b"));
+    EXPECT_FALSE(cache->cachedInfo(url("a/b/c/file")));
+    // the parent changed, its sibling did not
+    EXPECT_FALSE(cache->cachedInfo(url("a")));
+    EXPECT_TRUE(cache->cachedInfo(url("a/file")));
+    EXPECT_EQ(cache->count(), 1);
+}
+
+/**
+ * @brief TEST_F a renamed directory drops the entries below it, the counts of dropped entries are gone
+ */
+TEST_F(TestDFileInfoCache, invalidateRenamed)
+{
+    ASSERT_TRUE(cache->info(url("a/b/c/file")));
+    cache->remove(url("a/b/c/file"));
+    ASSERT_TRUE(cache->info(url("a/b/c/file")));
+    ASSERT_TRUE(cache->info(url("a/file")));
+
+    DWatcher watcher(QUrl::fromLocalFile(dir->path()));
+    cache->attachWatcher(&watcher);
+
+    Q_EMIT watcher.fileRenamed(url("a/b"), url("a/d"));
+    EXPECT_FALSE(cache->cachedInfo(url("a/b/c/file")));
+    EXPECT_TRUE(cache->cachedInfo(url("a/file")));
+
+    // a change of a file leaves its siblings
+    Q_EMIT watcher.fileChanged(url("a/other"));
+    EXPECT_TRUE(cache->cachedInfo(url("a/file")));
+    EXPECT_EQ(cache->count(), 1);
+}
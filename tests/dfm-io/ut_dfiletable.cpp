@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <dfm-io/dfiletable.h>
+#include <dfm-io/denumerator.h>
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QUrl>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDFileTable : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+
+            ASSERT_TRUE(QDir(dir->path()).mkpath("dir2"));
+            ASSERT_TRUE(QDir(dir->path()).mkpath("dir1"));
+            write("b.txt", 30);
+            write("a.txt", 10);
+            write("c.txt", 20);
+            write("file10", 5);
+            write("file9", 6);
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        void write(const QString &name, int size)
+        {
+            QFile file(dir->filePath(name));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            file.write(QByteArray(size, 'x'));
+        }
+
+        DFileTable table()
+        {
+            DEnumerator enumerator(QUrl::fromLocalFile(dir->path()));
+            enumerator.setSortRole(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName);
+            enumerator.setSortOrder(Qt::AscendingOrder);
+            enumerator.setSortMixed(false);
+            return enumerator.sortFileTable();
+        }
+
+        static QStringList names(const DFileTable &table, int count = -1)
+        {
+            QStringList list;
+            const int end = count < 0 ? table.count() : count;
+            for (int pos = 0; pos < end; ++pos)
+                list.append(table[pos].fileName());
+            return list;
+        }
+    };
+}
+
+/**
+ * @brief TEST_F rows in name order, directories first, with the values of the files
+ */
+TEST_F(TestDFileTable, sortByName)
+{
+    const DFileTable &sorted = table();
+    EXPECT_EQ(sorted.dirUrl(), QUrl::fromLocalFile(dir->path()));
+    ASSERT_EQ(sorted.count(), 7);
+    EXPECT_EQ(names(sorted), QStringList({ "dir1", "dir2", "a.txt", "b.txt", "c.txt", "file9", "file10" }));
+
+    const DFileTable::Row &row = sorted[2];
+    EXPECT_STREQ(row.name(), "a.txt");
+    EXPECT_EQ(row.nameLength(), 5);
+    EXPECT_EQ(row.url(), QUrl::fromLocalFile(dir->filePath("a.txt")));
+    EXPECT_EQ(row.size(), 10);
+    EXPECT_TRUE(row.isFile());
+    EXPECT_FALSE(row.isDir());
+    EXPECT_FALSE(row.isSymLink());
+    EXPECT_TRUE(sorted[0].isDir());
+
+    // the objects of sortFileInfoList() hold the same values in the same order
+    const auto &infos = sorted.toSortFileInfoList();
+    ASSERT_EQ(infos.size(), sorted.count());
+    for (int pos = 0; pos < sorted.count(); ++pos) {
+        EXPECT_EQ(infos.at(pos)->url, sorted[pos].url());
+        EXPECT_EQ(infos.at(pos)->filesize, sorted[pos].size());
+        EXPECT_EQ(infos.at(pos)->inode, sorted[pos].inode());
+        EXPECT_EQ(infos.at(pos)->isDir, sorted[pos].isDir());
+    }
+}
+
+/**
+ * @brief TEST_F sorting again only reorders the rows
+ */
+TEST_F(TestDFileTable, sortBySize)
+{
+    DFileTable sorted = table();
+    sorted.sort(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize, Qt::DescendingOrder, false);
+
+    // both directories first, their sizes are the same
+    EXPECT_TRUE(sorted[0].isDir());
+    EXPECT_TRUE(sorted[1].isDir());
+    EXPECT_EQ(names(sorted).mid(2), QStringList({ "b.txt", "c.txt", "a.txt", "file9", "file10" }));
+}
+
+/**
+ * @brief TEST_F a partial sort gives the first rows of the full order, a copy sorts on its own
+ */
+TEST_F(TestDFileTable, partialSort)
+{
+    const DFileTable &full = table();
+    const QStringList &order = names(full);
+
+    DFileTable partial = full;
+    partial.sort(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileSize, Qt::AscendingOrder, true);
+    partial.partialSort(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName, Qt::AscendingOrder, false, 3);
+    EXPECT_GE(partial.sortedCount(), 3);
+    EXPECT_EQ(names(partial, 3), order.mid(0, 3));
+
+    partial.sortMore(partial.count());
+    EXPECT_EQ(partial.sortedCount(), partial.count());
+    EXPECT_EQ(names(partial), order);
+
+    // the copy was sorted, not the table it came from
+    EXPECT_EQ(names(full), order);
+}
+
+/**
+ * @brief TEST an empty table
+ */
+TEST(TestDFileTableEmpty, empty)
+{
+    DFileTable table;
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_EQ(table.count(), 0);
+    table.sort(DEnumerator::SortRoleCompareFlag::kSortRoleCompareFileName, Qt::AscendingOrder, false);
+    EXPECT_TRUE(table.toSortFileInfoList().isEmpty());
+}
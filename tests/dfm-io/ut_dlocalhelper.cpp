@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "stub.h"
+
+#include "utils/dlocalhelper.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <gio/gio.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    int loadCount = 0;
+
+    gboolean countLoadContents(GFile *, GCancellable *, char **, gsize *, char **, GError **)
+    {
+        ++loadCount;
+        return false;
+    }
+
+    class TestDLocalHelperHideList : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        QUrl hiddenUrl;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            hiddenUrl = QUrl::fromLocalFile(dir->filePath(".hidden"));
+            loadCount = 0;
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        void write(const QByteArray &data)
+        {
+            QFile file(hiddenUrl.toLocalFile());
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+            file.write(data);
+        }
+    };
+}
+
+/**
+ * @brief TEST_F a .hidden file is read once while it is unchanged
+ */
+TEST_F(TestDLocalHelperHideList, cached)
+{
+    write("a\nb\n\n");
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "a", "b" }));
+
+    Stub stub;
+    stub.set(g_file_load_contents, countLoadContents);
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "a", "b" }));
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "a", "b" }));
+    EXPECT_EQ(loadCount, 0);
+}
+
+/**
+ * @brief TEST_F a changed .hidden file is read again, a removed one lists nothing
+ */
+TEST_F(TestDLocalHelperHideList, changed)
+{
+    write("a\n");
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "a" }));
+
+    write("b\nc\n");
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "b", "c" }));
+
+    ASSERT_TRUE(QFile::remove(hiddenUrl.toLocalFile()));
+    EXPECT_TRUE(DLocalHelper::hideListFromUrl(hiddenUrl).isEmpty());
+
+    // created again with the old content
+    write("a\n");
+    EXPECT_EQ(DLocalHelper::hideListFromUrl(hiddenUrl), QSet<QString>({ "a" }));
+}
@@ -0,0 +1,208 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dlocalparallelwalker.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <set>
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDLocalParallelWalker : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        std::string root;
+        // d0..d3 with f0..f9 and s/f0..s/f4 each
+        size_t entryCount = 0;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            root = dir->path().toStdString();
+
+            QDir rootDir(dir->path());
+            for (int i = 0; i < 4; ++i) {
+                const QString sub = QString("d%1").arg(i);
+                ASSERT_TRUE(rootDir.mkpath(sub + "/s"));
+                entryCount += 2;
+                for (int j = 0; j < 10; ++j) {
+                    touch(sub + QString("/f%1").arg(j));
+                    ++entryCount;
+                }
+                for (int j = 0; j < 5; ++j) {
+                    touch(sub + QString("/s/f%1").arg(j));
+                    ++entryCount;
+                }
+            }
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        void touch(const QString &name)
+        {
+            QFile file(dir->filePath(name));
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        }
+    };
+}
+
+/**
+ * @brief TEST_F unordered walk delivers every entry once and ends
+ */
+TEST_F(TestDLocalParallelWalker, unordered)
+{
+    DLocalParallelWalker::Options options;
+    options.threadCount = 4;
+    options.batchSize = 3;
+    options.queueCapacity = 2;
+    DLocalParallelWalker walker(root, options);
+    ASSERT_TRUE(walker.start());
+
+    std::multiset<std::string> paths;
+    DLocalParallelWalker::Batch batch;
+    while (walker.nextBatch(&batch)) {
+        for (size_t i = 0; i < batch.size(); ++i)
+            paths.insert(batch.dirPath + "/" + batch.name(i));
+    }
+
+    EXPECT_EQ(paths.size(), entryCount);
+    EXPECT_EQ(std::set<std::string>(paths.begin(), paths.end()).size(), entryCount);
+    EXPECT_EQ(walker.lastErrno(), 0);
+    EXPECT_FALSE(walker.nextBatch(&batch));
+}
+
+/**
+ * @brief TEST_F ordered walk delivers parents before children
+ */
+TEST_F(TestDLocalParallelWalker, ordered)
+{
+    DLocalParallelWalker::Options options;
+    options.threadCount = 4;
+    options.batchSize = 3;
+    options.queueCapacity = 2;
+    options.ordered = true;
+    DLocalParallelWalker walker(root, options);
+    ASSERT_TRUE(walker.start());
+
+    std::set<std::string> seen { root };
+    std::string current;
+    std::set<std::string> finishedDirs;
+    size_t count = 0;
+    DLocalParallelWalker::Batch batch;
+    while (walker.nextBatch(&batch)) {
+        EXPECT_TRUE(seen.count(batch.dirPath)) << batch.dirPath;
+        // every directory is delivered contiguously
+        if (batch.dirPath != current) {
+            EXPECT_FALSE(finishedDirs.count(batch.dirPath)) << batch.dirPath;
+            finishedDirs.insert(current);
+            current = batch.dirPath;
+        }
+        for (size_t i = 0; i < batch.size(); ++i)
+            seen.insert(batch.dirPath + "/" + batch.name(i));
+        count += batch.size();
+    }
+
+    EXPECT_EQ(count, entryCount);
+}
+
+/**
+ * @brief TEST_F symlink loops end when following symlinks
+ */
+TEST_F(TestDLocalParallelWalker, symlinkLoop)
+{
+    ASSERT_EQ(::symlink(root.c_str(), (root + "/d0/loop").c_str()), 0);
+
+    DLocalParallelWalker::Options options;
+    options.followSymlinks = true;
+    DLocalParallelWalker walker(root, options);
+    ASSERT_TRUE(walker.start());
+
+    size_t count = 0;
+    DLocalParallelWalker::Batch batch;
+    while (walker.nextBatch(&batch)) {
+        EXPECT_NE(batch.dirPath, root + "/d0/loop");
+        count += batch.size();
+    }
+
+    EXPECT_EQ(count, entryCount + 1);
+}
+
+/**
+ * @brief TEST_F unreadable subdirectories are skipped without failing the walk
+ */
+TEST_F(TestDLocalParallelWalker, unreadableChild)
+{
+    if (geteuid() == 0)
+        GTEST_SKIP() << "root reads any directory";
+
+    const std::string locked = root + "/d1/s";
+    ASSERT_EQ(::chmod(locked.c_str(), 0), 0);
+
+    DLocalParallelWalker::Options options;
+    options.threadCount = 4;
+    DLocalParallelWalker walker(root, options);
+    ASSERT_TRUE(walker.start());
+
+    size_t count = 0;
+    DLocalParallelWalker::Batch batch;
+    while (walker.nextBatch(&batch)) {
+        EXPECT_NE(batch.dirPath, locked);
+        count += batch.size();
+    }
+    ::chmod(locked.c_str(), 0755);
+
+    // d1/s itself is listed, its 5 files are not
+    EXPECT_EQ(count, entryCount - 5);
+    EXPECT_EQ(walker.lastErrno(), 0);
+}
+
+/**
+ * @brief TEST_F stop ends a walk the consumer does not drain
+ */
+TEST_F(TestDLocalParallelWalker, stop)
+{
+    DLocalParallelWalker::Options options;
+    options.threadCount = 4;
+    options.batchSize = 1;
+    options.queueCapacity = 1;
+    DLocalParallelWalker walker(root, options);
+    ASSERT_TRUE(walker.start());
+
+    DLocalParallelWalker::Batch batch;
+    EXPECT_TRUE(walker.nextBatch(&batch));
+
+    // the workers are blocked on the full queue, stop() must wake and join them
+    walker.stop();
+    EXPECT_TRUE(walker.isStopped());
+    EXPECT_FALSE(walker.nextBatch(&batch));
+}
+
+/**
+ * @brief TEST start fails on a missing directory
+ */
+TEST(TestDLocalParallelWalkerError, missingRoot)
+{
+    DLocalParallelWalker walker("/nonexistent-dfm-io-test", DLocalParallelWalker::Options());
+    EXPECT_FALSE(walker.start());
+    EXPECT_EQ(walker.lastErrno(), ENOENT);
+
+    DLocalParallelWalker::Batch batch;
+    EXPECT_FALSE(walker.nextBatch(&batch));
+}
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2022 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dmediainfo.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDMediaInfo : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            for (int i = 0; i < 20; ++i) {
+                QFile file(dir->filePath(QString("f%1.txt").arg(i)));
+                ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+                file.write("not a media file");
+            }
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        // true once count reaches expected, false after 10 s
+        static bool waitFor(const std::atomic_int &count, int expected)
+        {
+            for (int i = 0; i < 1000 && count < expected; ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return count >= expected;
+        }
+    };
+}
+
+/**
+ * @brief TEST_F every read calls its callback once, on the shared pool
+ */
+TEST_F(TestDMediaInfo, callbacks)
+{
+    std::atomic_int count { 0 };
+    std::vector<std::unique_ptr<DMediaInfo>> infos;
+    for (int i = 0; i < 20; ++i) {
+        infos.emplace_back(new DMediaInfo(dir->filePath(QString("f%1.txt").arg(i))));
+        infos.back()->startReadInfo([&count](bool) { ++count; }, i % 3);
+    }
+
+    EXPECT_TRUE(waitFor(count, 20));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(count, 20);
+}
+
+/**
+ * @brief TEST_F a file that can not be opened reports it
+ */
+TEST_F(TestDMediaInfo, missingFile)
+{
+    std::atomic_int count { 0 };
+    std::atomic_bool opened { true };
+    DMediaInfo info(dir->filePath("missing.mp4"));
+    info.startReadInfo([&](bool ok) {
+        opened = ok;
+        ++count;
+    });
+
+    ASSERT_TRUE(waitFor(count, 1));
+    EXPECT_FALSE(opened);
+    EXPECT_TRUE(info.value("Duration").isEmpty());
+}
+
+/**
+ * @brief TEST_F no callback runs after stopReadInfo() returns, stopped objects can be destroyed at once
+ */
+TEST_F(TestDMediaInfo, stop)
+{
+    std::atomic_int count { 0 };
+    std::vector<std::unique_ptr<DMediaInfo>> infos;
+    for (int i = 0; i < 20; ++i) {
+        infos.emplace_back(new DMediaInfo(dir->filePath(QString("f%1.txt").arg(i))));
+        infos.back()->startReadInfo([&count](bool) { ++count; });
+    }
+    for (auto &info : infos)
+        info->stopReadInfo();
+
+    const int stopped = count;
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(count, stopped);
+    infos.clear();
+
+    // the pool goes on with new reads
+    DMediaInfo info(dir->filePath("f0.txt"));
+    std::atomic_int after { 0 };
+    info.startReadInfo([&after](bool) { ++after; });
+    EXPECT_TRUE(waitFor(after, 1));
+}
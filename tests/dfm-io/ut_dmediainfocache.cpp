@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2022 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dmediainfocache.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    class TestDMediaInfoCache : public testing::Test
+    {
+    public:
+        QTemporaryDir *dir = nullptr;
+        QString filePath;
+
+        virtual void SetUp() override
+        {
+            dir = new QTemporaryDir;
+            ASSERT_TRUE(dir->isValid());
+            filePath = dir->filePath("video.mp4");
+            QFile file(filePath);
+            ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+            file.write("0123456789");
+        }
+
+        virtual void TearDown() override
+        {
+            delete dir;
+            dir = nullptr;
+        }
+
+        struct statx stat()
+        {
+            struct statx st {};
+            EXPECT_EQ(::statx(AT_FDCWD, qPrintable(filePath), 0, STATX_BASIC_STATS, &st), 0);
+            return st;
+        }
+    };
+}
+
+/**
+ * @brief TEST_F values are found while the file is unchanged
+ */
+TEST_F(TestDMediaInfoCache, roundTrip)
+{
+    DMediaInfoCache *cache = DMediaInfoCache::instance();
+    const struct statx &st = stat();
+
+    DMediaInfoCache::Values values;
+    EXPECT_FALSE(cache->lookup(st, DFileInfo::MediaType::kVideo, &values));
+
+    cache->insert(st, DFileInfo::MediaType::kVideo, { "00:01:00", "640", "480" });
+    ASSERT_TRUE(cache->lookup(st, DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, QString("00:01:00"));
+    EXPECT_EQ(values.width, QString("640"));
+    EXPECT_EQ(values.height, QString("480"));
+    // another media type is another entry
+    EXPECT_FALSE(cache->lookup(st, DFileInfo::MediaType::kAudio, &values));
+
+    // changed: size and mtime differ
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("0123456789");
+    file.close();
+    EXPECT_FALSE(cache->lookup(stat(), DFileInfo::MediaType::kVideo, &values));
+}
+
+/**
+ * @brief TEST_F values that are all empty are not cached
+ */
+TEST_F(TestDMediaInfoCache, emptyValues)
+{
+    DMediaInfoCache *cache = DMediaInfoCache::instance();
+    const struct statx &st = stat();
+
+    cache->insert(st, DFileInfo::MediaType::kVideo, {});
+    DMediaInfoCache::Values values;
+    EXPECT_FALSE(cache->lookup(st, DFileInfo::MediaType::kVideo, &values));
+
+    // one value is enough
+    cache->insert(st, DFileInfo::MediaType::kVideo, { "00:01:00", QString(), QString() });
+    ASSERT_TRUE(cache->lookup(st, DFileInfo::MediaType::kVideo, &values));
+    EXPECT_EQ(values.duration, QString("00:01:00"));
+    EXPECT_TRUE(values.width.isEmpty());
+}
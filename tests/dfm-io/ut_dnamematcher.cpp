@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dnamematcher.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+USING_IO_NAMESPACE
+
+namespace  {
+    bool glob(const char *pattern, const char *name)
+    {
+        return DNameMatcher::globMatch(pattern, strlen(pattern), name, strlen(name));
+    }
+
+    bool match(const DNameMatcher &matcher, const QByteArray &name)
+    {
+        return matcher.matches(name.constData(), static_cast<size_t>(name.length()));
+    }
+}
+
+/**
+ * @brief TEST globMatch
+ */
+TEST(TestDNameMatcher, globMatch)
+{
+    EXPECT_TRUE(glob("*", ""));
+    EXPECT_TRUE(glob("a?c", "abc"));
+    EXPECT_FALSE(glob("a?c", "ac"));
+    EXPECT_TRUE(glob("a*b*c", "axxbyyc"));
+    EXPECT_FALSE(glob("a*b*c", "axxbyy"));
+    EXPECT_TRUE(glob("[abc]x", "bx"));
+    EXPECT_FALSE(glob("[!abc]x", "bx"));
+    EXPECT_TRUE(glob("[a-f]1", "e1"));
+    EXPECT_FALSE(glob("[a-f]1", "g1"));
+    // a class matches one code point, not one byte
+    EXPECT_TRUE(glob("?.txt", "文.txt"));
+    EXPECT_TRUE(glob("[文字].txt", "字.txt"));
+    // without a closing ']' the '[' is a normal character
+    EXPECT_TRUE(glob("[ab", "[ab"));
+    EXPECT_FALSE(glob("[ab", "a"));
+}
+
+/**
+ * @brief TEST exact, prefix and suffix patterns
+ */
+TEST(TestDNameMatcher, hashedPatterns)
+{
+    DNameMatcher matcher;
+    EXPECT_TRUE(matcher.isEmpty());
+
+    matcher.compile({ "Makefile", "*.jpg", "IMG_*", "" }, true);
+    EXPECT_FALSE(matcher.isEmpty());
+    EXPECT_TRUE(match(matcher, "Makefile"));
+    EXPECT_FALSE(match(matcher, "Makefile.am"));
+    EXPECT_TRUE(match(matcher, "a.jpg"));
+    EXPECT_TRUE(match(matcher, ".jpg"));
+    EXPECT_FALSE(match(matcher, "a.jpeg"));
+    EXPECT_FALSE(match(matcher, "jpg"));
+    EXPECT_TRUE(match(matcher, "IMG_0001.png"));
+    EXPECT_FALSE(match(matcher, "IMG"));
+
+    matcher.compile({ "*.[ch]" }, true);
+    EXPECT_TRUE(match(matcher, "main.c"));
+    EXPECT_TRUE(match(matcher, "main.h"));
+    EXPECT_FALSE(match(matcher, "main.cpp"));
+
+    matcher.compile({ "*" }, true);
+    EXPECT_TRUE(match(matcher, "anything"));
+
+    matcher.clear();
+    EXPECT_TRUE(matcher.isEmpty());
+}
+
+/**
+ * @brief TEST case folding
+ */
+TEST(TestDNameMatcher, caseFolding)
+{
+    DNameMatcher matcher;
+    matcher.compile({ "*.JPG", "readme", "Ä*" }, false);
+    EXPECT_TRUE(match(matcher, "photo.jpg"));
+    EXPECT_TRUE(match(matcher, "photo.Jpg"));
+    EXPECT_TRUE(match(matcher, "README"));
+    // names that are not ascii are folded through QString
+    EXPECT_TRUE(match(matcher, "äpfel"));
+    EXPECT_TRUE(match(matcher, "ÄPFEL"));
+    EXPECT_FALSE(match(matcher, "apfel"));
+
+    matcher.compile({ "*.JPG" }, true);
+    EXPECT_FALSE(match(matcher, "photo.jpg"));
+    EXPECT_TRUE(match(matcher, "photo.JPG"));
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2020 - 2023 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "utils/dsortkeybuilder.h"
+#include "utils/dlocalhelper.h"
+
+#include <gtest/gtest.h>
+
+#include <QPair>
+#include <QStringList>
+
+USING_IO_NAMESPACE
+
+/**
+ * @brief TEST the keys give the order of compareByStringEx
+ */
+TEST(TestDSortKeyBuilder, keyOrder)
+{
+    // already in name order: numbers by value → letters (a A b B) → 汉字 → other characters
+    const QStringList names { "1", "2", "10", "a1", "a2", "a10", "B", "c", "x.doc", "x.txt", "文", "~" };
+
+    DSortKeyBuilder builder;
+    for (const QString &name : names)
+        builder.addName(name);
+    builder.prepare();
+
+    for (int i = 0; i < names.size(); ++i) {
+        for (int j = i + 1; j < names.size(); ++j) {
+            const QString &left = names.at(i);
+            const QString &right = names.at(j);
+            EXPECT_TRUE(DLocalHelper::compareByStringEx(left, right)) << qPrintable(left) << " " << qPrintable(right);
+            EXPECT_LT(builder.key(left), builder.key(right)) << qPrintable(left) << " " << qPrintable(right);
+        }
+    }
+}
+
+/**
+ * @brief TEST a name without '.' is its own suffix, as in compareByStringEx
+ */
+TEST(TestDSortKeyBuilder, suffixOfNamesWithoutDot)
+{
+    DSortKeyBuilder builder;
+    builder.prepare();
+
+    // same base name: "aaa" < "abc", "txt" < "x", the empty suffix of "abc." is first
+    const QList<QPair<QString, QString>> ordered {
+        { "abc.aaa", "abc" },
+        { "abc.", "abc.aaa" },
+        { "abc.", "abc" },
+        { "x.txt", "x" },
+    };
+    for (const auto &pair : ordered) {
+        EXPECT_TRUE(DLocalHelper::compareByStringEx(pair.first, pair.second)) << qPrintable(pair.first) << " " << qPrintable(pair.second);
+        EXPECT_FALSE(DLocalHelper::compareByStringEx(pair.second, pair.first)) << qPrintable(pair.second) << " " << qPrintable(pair.first);
+        EXPECT_LT(builder.key(pair.first), builder.key(pair.second)) << qPrintable(pair.first) << " " << qPrintable(pair.second);
+    }
+}
+
+/**
+ * @brief TEST numbers compare by value, not by digits
+ */
+TEST(TestDSortKeyBuilder, numbers)
+{
+    DSortKeyBuilder builder;
+    builder.prepare();
+
+    EXPECT_LT(builder.key("file9"), builder.key("file10"));
+    EXPECT_LT(builder.key("file2"), builder.key("file012"));
+    // same value: still a stable order
+    EXPECT_NE(builder.key("file1"), builder.key("file01"));
+}
+
+/**
+ * @brief TEST names only different in case get distinct keys
+ */
+TEST(TestDSortKeyBuilder, caseOnly)
+{
+    DSortKeyBuilder builder;
+    builder.prepare();
+
+    EXPECT_LT(builder.key("a"), builder.key("B"));
+    EXPECT_LT(builder.key("A"), builder.key("b"));
+    EXPECT_NE(builder.key("a"), builder.key("A"));
+}
+
+/**
+ * @brief TEST 汉字 follow the collation order
+ */
+TEST(TestDSortKeyBuilder, han)
+{
+    const QStringList names { "中文", "文件", "新建", "阿" };
+
+    DSortKeyBuilder builder;
+    for (const QString &name : names)
+        builder.addName(name);
+    builder.prepare();
+
+    for (const QString &left : names) {
+        for (const QString &right : names) {
+            if (left == right)
+                continue;
+            EXPECT_EQ(builder.key(left) < builder.key(right), DLocalHelper::compareByStringEx(left, right))
+                    << qPrintable(left) << " " << qPrintable(right);
+        }
+    }
+}